@@ -0,0 +1,48 @@
+#ifndef ALEATORIO_H
+#define ALEATORIO_H
+
+#include <stdint.h>
+
+// Gerador PCG32 (XSH-RR) por instância: 8 bytes de estado, sem estado global,
+// então cada partida ou thread tem sua própria sequência reproduzível
+typedef struct {
+    uint64_t estado;
+} Aleatorio;
+
+#define ALEATORIO_MULTIPLICADOR 6364136223846793005ULL
+#define ALEATORIO_INCREMENTO 1442695040888963407ULL
+
+static inline uint32_t proximo_aleatorio(Aleatorio *a) {
+    uint64_t anterior = a->estado;
+    a->estado = anterior * ALEATORIO_MULTIPLICADOR + ALEATORIO_INCREMENTO;
+    uint32_t xorshifted = (uint32_t)(((anterior >> 18) ^ anterior) >> 27);
+    uint32_t rotacao = (uint32_t)(anterior >> 59);
+    return (xorshifted >> rotacao) | (xorshifted << ((-rotacao) & 31));
+}
+
+static inline void semear_aleatorio(Aleatorio *a, uint64_t semente) {
+    a->estado = 0;
+    proximo_aleatorio(a);
+    a->estado += semente;
+    proximo_aleatorio(a);
+}
+
+// Inteiro uniforme em [0, limite) pelo método multiplicação-deslocamento
+static inline uint32_t aleatorio_intervalo(Aleatorio *a, uint32_t limite) {
+    return (uint32_t)(((uint64_t)proximo_aleatorio(a) * limite) >> 32);
+}
+
+// Real uniforme em [0, 1)
+static inline double aleatorio_real(Aleatorio *a) {
+    return proximo_aleatorio(a) * (1.0 / 4294967296.0);
+}
+
+// Mistura SplitMix64: deriva sementes independentes de uma semente base e um índice
+static inline uint64_t misturar_semente(uint64_t semente, uint64_t indice) {
+    uint64_t z = semente + (indice + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+#endif
@@ -0,0 +1,364 @@
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include "jogo.h"
+#include "tela.h"
+#include "rede.h"
+#include "mundo.h"
+#include "estado.h"
+
+// Quadros consecutivos pré-simulados que alimentam todos os benchmarks
+#define NUM_ESTADOS 1024
+
+typedef struct {
+    const char *nome;
+    long iteracoes;
+    long long ns;
+    size_t bytes;
+} Medida;
+
+static Jogo estados[NUM_ESTADOS];
+static Jogo copias[NUM_ESTADOS];
+static Tela tela;
+static long iteracoes = 200000;
+
+static long long agora_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Gera uma sequência de quadros de partidas jogadas pela política do vão,
+// recomeçando com outra semente a cada game over
+static void simular_estados(uint64_t semente, int largura, int altura) {
+    Jogo jogo;
+    inicializar_jogo(&jogo, semente, largura, altura, DIFICULDADE_CLASSICA);
+    for (int i = 0; i < NUM_ESTADOS; i++) {
+        if (politica_seguir_vao(&jogo)) {
+            pular(&jogo);
+        }
+        avancar_jogo(&jogo);
+        if (jogo.game_over) {
+            inicializar_jogo(&jogo, misturar_semente(semente, i), largura, altura, DIFICULDADE_CLASSICA);
+        }
+        estados[i] = jogo;
+    }
+}
+
+// Roda uma etapa que altera o jogo sobre cópias dos estados; a cópia fica fora da medição
+static Medida medir_mutavel(const char *nome, void (*etapa)(Jogo *)) {
+    Medida m = { nome, 0, 0, 0 };
+    while (m.iteracoes < iteracoes) {
+        memcpy(copias, estados, sizeof(estados));
+        long long inicio = agora_ns();
+        for (int i = 0; i < NUM_ESTADOS; i++) {
+            etapa(&copias[i]);
+        }
+        m.ns += agora_ns() - inicio;
+        m.iteracoes += NUM_ESTADOS;
+    }
+    return m;
+}
+
+static void desenhar_interface_jogando(Tela *t, const Jogo *jogo) {
+    desenhar_interface(t, jogo, 1);
+}
+
+static void desenhar_interface_menu(Tela *t, const Jogo *jogo) {
+    desenhar_interface(t, jogo, 0);
+}
+
+static void desenhar_obstaculos_etapa(Tela *t, const Jogo *jogo) {
+    desenhar_obstaculos(t, &jogo->obstaculos);
+}
+
+static void desenhar_passaro_etapa(Tela *t, const Jogo *jogo) {
+    desenhar_passaro(t, jogo, UM_FIXO / 2);
+}
+
+static void limpar_buffer_etapa(Tela *t, const Jogo *jogo) {
+    (void)jogo;
+    limpar_buffer(t);
+}
+
+// Roda uma etapa de desenho sobre os estados pré-simulados, sem alterá-los
+static Medida medir_desenho(const char *nome, void (*etapa)(Tela *, const Jogo *)) {
+    Medida m = { nome, iteracoes, 0, 0 };
+    limpar_buffer(&tela);
+    long long inicio = agora_ns();
+    for (long i = 0; i < iteracoes; i++) {
+        etapa(&tela, &estados[i & (NUM_ESTADOS - 1)]);
+    }
+    m.ns = agora_ns() - inicio;
+    return m;
+}
+
+static void compor_quadro(const Jogo *jogo) {
+    limpar_buffer(&tela);
+    desenhar_borda(&tela);
+    desenhar_obstaculos(&tela, &jogo->obstaculos);
+    desenhar_passaro(&tela, jogo, UM_FIXO);
+    desenhar_interface(&tela, jogo, 1);
+}
+
+// Mede só renderizar_tela: o quadro é composto fora da medição. Com redesenho,
+// cada quadro é enviado inteiro; sem ele, só a diferença para o anterior
+static Medida medir_renderizacao(const char *nome, int redesenho) {
+    Medida m = { nome, iteracoes, 0, 0 };
+    tela.redesenhar = 1;
+    for (long i = 0; i < iteracoes; i++) {
+        compor_quadro(&estados[i & (NUM_ESTADOS - 1)]);
+        if (redesenho) {
+            tela.redesenhar = 1;
+        }
+        long long inicio = agora_ns();
+        renderizar_tela(&tela);
+        m.ns += agora_ns() - inicio;
+        m.bytes += tela.bytes_quadro;
+    }
+    return m;
+}
+
+// Mede o quadro inteiro como no laço interativo: física, composição e escrita
+static Medida medir_quadro_completo(const char *nome) {
+    Medida m = { nome, iteracoes, 0, 0 };
+    Jogo jogo = estados[0];
+    tela.redesenhar = 1;
+    long long inicio = agora_ns();
+    for (long i = 0; i < iteracoes; i++) {
+        if (politica_seguir_vao(&jogo)) {
+            pular(&jogo);
+        }
+        avancar_jogo(&jogo);
+        if (jogo.game_over) {
+            jogo = estados[i & (NUM_ESTADOS - 1)];
+        }
+        compor_quadro(&jogo);
+        renderizar_tela(&tela);
+        m.bytes += tela.bytes_quadro;
+    }
+    m.ns = agora_ns() - inicio;
+    return m;
+}
+
+// Mede a passada de um bloco de redes com pesos aleatórios sobre as
+// observações dos estados pré-simulados; cada operação decide LARGURA_BLOCO_REDES pulos
+static Medida medir_rede_bloco(const char *nome) {
+    static ObservacoesBloco observacoes[NUM_ESTADOS];
+    static BlocoRedes bloco;
+    Rede redes[LARGURA_BLOCO_REDES];
+    Aleatorio aleatorio;
+    float observacao[ENTRADAS_REDE];
+    
+    semear_aleatorio(&aleatorio, 1);
+    for (int p = 0; p < LARGURA_BLOCO_REDES; p++) {
+        float *pesos = (float *)&redes[p];
+        for (int w = 0; w < NUM_PESOS_REDE; w++) {
+            pesos[w] = (float)(2.0 * aleatorio_real(&aleatorio) - 1.0);
+        }
+    }
+    empacotar_bloco(&bloco, redes, LARGURA_BLOCO_REDES);
+    for (int i = 0; i < NUM_ESTADOS; i++) {
+        for (int p = 0; p < LARGURA_BLOCO_REDES; p++) {
+            observar_jogo(&estados[(i + p) & (NUM_ESTADOS - 1)], observacao);
+            for (int e = 0; e < ENTRADAS_REDE; e++) {
+                observacoes[i].valores[e][p] = observacao[e];
+            }
+        }
+    }
+    
+    Medida m = { nome, iteracoes, 0, 0 };
+    volatile unsigned pulos = 0;
+    long long inicio = agora_ns();
+    for (long i = 0; i < iteracoes; i++) {
+        pulos += decidir_bloco(&bloco, &observacoes[i & (NUM_ESTADOS - 1)]);
+    }
+    m.ns = agora_ns() - inicio;
+    return m;
+}
+
+// Mede um quadro do modo com vários pássaros (decisão dos robôs e avanço do
+// mundo) com `num` robôs, recomeçando a rodada quando todos morrem
+static Medida medir_mundo(const char *nome, int num, uint64_t semente, int largura, int altura) {
+    Medida m = { nome, iteracoes, 0, 0 };
+    Mundo mundo;
+    long rodadas = 0;
+    if (inicializar_mundo(&mundo, num, 0, semente, largura, altura, DIFICULDADE_CLASSICA) != 0) {
+        fprintf(stderr, "Memória insuficiente para %d pássaros\n", num);
+        exit(1);
+    }
+    
+    long long inicio = agora_ns();
+    for (long i = 0; i < iteracoes; i++) {
+        pular_robos(&mundo);
+        avancar_mundo(&mundo);
+        if (mundo.game_over) {
+            reiniciar_mundo(&mundo, misturar_semente(semente, ++rodadas));
+        }
+    }
+    m.ns = agora_ns() - inicio;
+    liberar_mundo(&mundo);
+    return m;
+}
+
+// Mede o instantâneo que o jogo interativo guarda a cada passo de física
+// (um passo com o histórico somado a ele fica em avancar_jogo + esta medida)
+static Medida medir_historico(const char *nome) {
+    Medida m = { nome, iteracoes, 0, 0 };
+    Historico historico;
+    if (inicializar_historico(&historico) != 0) {
+        fprintf(stderr, "Memória insuficiente para o histórico\n");
+        exit(1);
+    }
+    
+    long long inicio = agora_ns();
+    for (long i = 0; i < iteracoes; i++) {
+        guardar_no_historico(&historico, &estados[i % NUM_ESTADOS]);
+    }
+    m.ns = agora_ns() - inicio;
+    liberar_historico(&historico);
+    return m;
+}
+
+// Mede o custo por obstáculo de tirar obstáculos da fila do gerador,
+// incluindo os lotes gerados quando ela esvazia
+static Medida medir_gerador(const char *nome, int dificuldade, uint64_t semente, int altura) {
+    Medida m = { nome, iteracoes, 0, 0 };
+    Gerador gerador;
+    volatile unsigned soma = 0;
+    iniciar_gerador(&gerador, semente, dificuldade);
+    
+    long long inicio = agora_ns();
+    for (long i = 0; i < iteracoes; i++) {
+        soma += proximo_gerado(&gerador, altura)->altura_superior;
+        consumir_gerado(&gerador);
+    }
+    m.ns = agora_ns() - inicio;
+    return m;
+}
+
+// Imprime uma medida como uma linha JSON
+static void imprimir_medida(const Medida *m) {
+    double ns_por_op = (double)m->ns / m->iteracoes;
+    printf("{\"nome\":\"%s\",\"iteracoes\":%ld,\"ns_por_op\":%.1f,"
+           "\"quadros_por_s\":%.0f,\"bytes_por_quadro\":%.1f}\n",
+           m->nome, m->iteracoes, ns_por_op,
+           ns_por_op > 0 ? 1e9 / ns_por_op : 0.0,
+           (double)m->bytes / m->iteracoes);
+    fflush(stdout);
+}
+
+static void mostrar_uso(const char *programa) {
+    printf("Uso: %s [opções]\n", programa);
+    printf("  --iterations N   Operações medidas por benchmark (padrão 200000)\n");
+    printf("  --width N        Largura do campo (padrão %d)\n", LARGURA_TELA);
+    printf("  --height N       Altura do campo (padrão %d)\n", ALTURA_TELA);
+    printf("  --seed N         Semente das partidas simuladas (padrão 1)\n");
+    printf("  --output ARQ     Destino da renderização (padrão /dev/null)\n");
+    printf("  --unicode        Desenha o pássaro com blocos Unicode\n");
+    printf("  --color          Modo colorido com bordas Unicode (inclui --unicode)\n");
+}
+
+int main(int argc, char *argv[]) {
+    int largura = LARGURA_TELA;
+    int altura = ALTURA_TELA;
+    uint64_t semente = 1;
+    const char *destino = "/dev/null";
+    int unicode = 0;
+    int cores = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iteracoes = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--width") == 0 && i + 1 < argc) {
+            largura = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--height") == 0 && i + 1 < argc) {
+            altura = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            semente = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            destino = argv[++i];
+        } else if (strcmp(argv[i], "--unicode") == 0) {
+            unicode = 1;
+        } else if (strcmp(argv[i], "--color") == 0) {
+            cores = 1;
+        } else {
+            mostrar_uso(argv[0]);
+            return strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    if (iteracoes < 1 || largura < LARGURA_MINIMA || largura > LARGURA_MAXIMA ||
+        altura < ALTURA_MINIMA || altura > ALTURA_MAXIMA) {
+        fprintf(stderr, "Parâmetros inválidos (campo entre %dx%d e %dx%d)\n",
+                LARGURA_MINIMA, ALTURA_MINIMA, LARGURA_MAXIMA, ALTURA_MAXIMA);
+        return 1;
+    }
+
+    if (inicializar_tela(&tela, largura, altura) != 0) {
+        fprintf(stderr, "Memória insuficiente para a tela\n");
+        return 1;
+    }
+    tela.descritor = open(destino, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (tela.descritor < 0) {
+        perror(destino);
+        liberar_tela(&tela);
+        return 1;
+    }
+    tela.unicode = unicode;
+    if (cores) {
+        ativar_cores(&tela);
+    }
+
+    simular_estados(semente, largura, altura);
+
+    Medida m;
+    m = medir_mutavel("atualizar_passaro", atualizar_passaro);
+    imprimir_medida(&m);
+    m = medir_mutavel("atualizar_obstaculos", atualizar_obstaculos);
+    imprimir_medida(&m);
+    m = medir_mutavel("colisao_obstaculos", verificar_colisao_obstaculos);
+    imprimir_medida(&m);
+    m = medir_mutavel("avancar_jogo", avancar_jogo);
+    imprimir_medida(&m);
+    m = medir_historico("guardar_no_historico");
+    imprimir_medida(&m);
+    m = medir_gerador("gerar_obstaculo_classico", DIFICULDADE_CLASSICA, semente, altura);
+    imprimir_medida(&m);
+    m = medir_gerador("gerar_obstaculo_progressivo", DIFICULDADE_PROGRESSIVA, semente, altura);
+    imprimir_medida(&m);
+    m = medir_mundo("avancar_mundo_1", 1, semente, largura, altura);
+    imprimir_medida(&m);
+    m = medir_mundo("avancar_mundo_64", 64, semente, largura, altura);
+    imprimir_medida(&m);
+    m = medir_mundo("avancar_mundo_1024", 1024, semente, largura, altura);
+    imprimir_medida(&m);
+    m = medir_mundo("avancar_mundo_4096", 4096, semente, largura, altura);
+    imprimir_medida(&m);
+    m = medir_rede_bloco("decidir_bloco_redes");
+    imprimir_medida(&m);
+    m = medir_desenho("limpar_buffer", limpar_buffer_etapa);
+    imprimir_medida(&m);
+    m = medir_desenho("desenhar_obstaculos", desenhar_obstaculos_etapa);
+    imprimir_medida(&m);
+    m = medir_desenho("desenhar_passaro", desenhar_passaro_etapa);
+    imprimir_medida(&m);
+    m = medir_desenho("desenhar_interface", desenhar_interface_jogando);
+    imprimir_medida(&m);
+    m = medir_desenho("desenhar_interface_menu", desenhar_interface_menu);
+    imprimir_medida(&m);
+    m = medir_renderizacao("renderizar_tela_diff", 0);
+    imprimir_medida(&m);
+    m = medir_renderizacao("renderizar_tela_completa", 1);
+    imprimir_medida(&m);
+    m = medir_quadro_completo("quadro_completo");
+    imprimir_medida(&m);
+
+    close(tela.descritor);
+    liberar_tela(&tela);
+    return 0;
+}
@@ -0,0 +1,180 @@
+#define _DEFAULT_SOURCE
+#include <stdatomic.h>
+#include <pthread.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include "entrada.h"
+
+// Fila circular de um produtor (thread de entrada) e um consumidor (loop do
+// jogo). Cada índice só é escrito por um lado, então basta publicar com
+// release e ler com acquire; cabeça e cauda ficam em linhas de cache separadas
+typedef struct {
+    EventoTecla eventos[CAPACIDADE_FILA_TECLAS];
+    _Alignas(64) _Atomic uint32_t cabeca;
+    _Alignas(64) _Atomic uint32_t cauda;
+} FilaTeclas;
+
+static FilaTeclas fila;
+static pthread_t thread_entrada;
+static int pipe_parada[2] = { -1, -1 };
+static int pipe_despertar[2] = { -1, -1 };
+static int entrada_ativa = 0;
+
+static long long instante_atual_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Publica uma tecla na fila; se estiver cheia a tecla é descartada
+static void empilhar_tecla(char tecla, long long instante_ns) {
+    uint32_t cabeca = atomic_load_explicit(&fila.cabeca, memory_order_relaxed);
+    uint32_t cauda = atomic_load_explicit(&fila.cauda, memory_order_acquire);
+    
+    if (cabeca - cauda == CAPACIDADE_FILA_TECLAS) {
+        return;
+    }
+    
+    EventoTecla *evento = &fila.eventos[cabeca & (CAPACIDADE_FILA_TECLAS - 1)];
+    evento->tecla = tecla;
+    evento->instante_ns = instante_ns;
+    atomic_store_explicit(&fila.cabeca, cabeca + 1, memory_order_release);
+}
+
+// Thread de entrada: bloqueia em poll() até chegar tecla ou pedido de parada,
+// então o loop do jogo não faz nenhuma chamada de sistema para ler o teclado
+static void *executar_entrada(void *arg) {
+    (void)arg;
+    struct pollfd fds[2] = {
+        { .fd = STDIN_FILENO, .events = POLLIN },
+        { .fd = pipe_parada[0], .events = POLLIN },
+    };
+    char teclas[64];
+    
+    while (1) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (fds[1].revents) {
+            break;
+        }
+        if (fds[0].revents & (POLLERR | POLLHUP | POLLNVAL)) {
+            break;
+        }
+        
+        ssize_t lidas = read(STDIN_FILENO, teclas, sizeof(teclas));
+        if (lidas <= 0) {
+            if (lidas < 0 && errno == EINTR) continue;
+            break;
+        }
+        
+        long long instante = instante_atual_ns();
+        for (ssize_t i = 0; i < lidas; i++) {
+            empilhar_tecla(teclas[i], instante);
+        }
+        acordar_loop();
+    }
+    return NULL;
+}
+
+// Fecha as duas pontas de um pipe
+static void fechar_pipe(int fds[2]) {
+    close(fds[0]);
+    close(fds[1]);
+    fds[0] = fds[1] = -1;
+}
+
+// Inicia a thread que lê o teclado; retorna 0 em sucesso
+int iniciar_entrada(void) {
+    if (pipe(pipe_parada) != 0) {
+        return -1;
+    }
+    // O pipe de despertar nunca bloqueia: cheio, ele já vai acordar o loop
+    if (pipe(pipe_despertar) != 0) {
+        fechar_pipe(pipe_parada);
+        return -1;
+    }
+    fcntl(pipe_despertar[0], F_SETFL, O_NONBLOCK);
+    fcntl(pipe_despertar[1], F_SETFL, O_NONBLOCK);
+    if (pthread_create(&thread_entrada, NULL, executar_entrada, NULL) != 0) {
+        fechar_pipe(pipe_parada);
+        fechar_pipe(pipe_despertar);
+        return -1;
+    }
+    entrada_ativa = 1;
+    return 0;
+}
+
+// Acorda a thread de entrada, espera seu fim e libera o pipe de parada
+void parar_entrada(void) {
+    if (!entrada_ativa) {
+        return;
+    }
+    
+    char sinal = 1;
+    while (write(pipe_parada[1], &sinal, 1) < 0 && errno == EINTR);
+    pthread_join(thread_entrada, NULL);
+    fechar_pipe(pipe_parada);
+    fechar_pipe(pipe_despertar);
+    entrada_ativa = 0;
+}
+
+// Acorda o loop do jogo parado em esperar_entrada(); pode ser chamada de
+// qualquer thread e de tratadores de sinal
+void acordar_loop(void) {
+    int erro_salvo = errno;
+    char sinal = 1;
+    if (pipe_despertar[1] >= 0) {
+        while (write(pipe_despertar[1], &sinal, 1) < 0 && errno == EINTR);
+    }
+    errno = erro_salvo;
+}
+
+// Descarta os pedidos de despertar acumulados
+static void esvaziar_despertar(void) {
+    char descarte[64];
+    while (read(pipe_despertar[0], descarte, sizeof(descarte)) > 0);
+}
+
+// Bloqueia o loop do jogo até chegar uma tecla ou alguém chamar acordar_loop().
+// Os pedidos antigos são descartados antes de olhar a fila, então uma tecla que
+// chegue entre essa verificação e o poll() ainda deixa um byte para acordá-lo
+void esperar_entrada(void) {
+    if (!entrada_ativa) {
+        return;
+    }
+    
+    esvaziar_despertar();
+    if (atomic_load_explicit(&fila.cabeca, memory_order_acquire) !=
+        atomic_load_explicit(&fila.cauda, memory_order_relaxed)) {
+        return;
+    }
+    
+    struct pollfd fd = { .fd = pipe_despertar[0], .events = POLLIN };
+    poll(&fd, 1, -1);
+    esvaziar_despertar();
+}
+
+// Retira a próxima tecla lida até o instante limite; retorna 0 se não há
+// tecla ou se a próxima é mais nova que o limite (fica para depois)
+int retirar_tecla_ate(long long limite_ns, EventoTecla *evento) {
+    uint32_t cauda = atomic_load_explicit(&fila.cauda, memory_order_relaxed);
+    uint32_t cabeca = atomic_load_explicit(&fila.cabeca, memory_order_acquire);
+    
+    if (cauda == cabeca) {
+        return 0;
+    }
+    
+    const EventoTecla *proximo = &fila.eventos[cauda & (CAPACIDADE_FILA_TECLAS - 1)];
+    if (proximo->instante_ns > limite_ns) {
+        return 0;
+    }
+    
+    *evento = *proximo;
+    atomic_store_explicit(&fila.cauda, cauda + 1, memory_order_release);
+    return 1;
+}
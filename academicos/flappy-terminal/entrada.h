@@ -0,0 +1,20 @@
+#ifndef ENTRADA_H
+#define ENTRADA_H
+
+#include <stdint.h>
+
+#define CAPACIDADE_FILA_TECLAS 256
+
+// Tecla lida pela thread de entrada, com o instante (relógio monotônico) da leitura
+typedef struct {
+    long long instante_ns;
+    char tecla;
+} EventoTecla;
+
+int iniciar_entrada(void);
+void parar_entrada(void);
+int retirar_tecla_ate(long long limite_ns, EventoTecla *evento);
+void esperar_entrada(void);
+void acordar_loop(void);
+
+#endif
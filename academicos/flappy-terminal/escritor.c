@@ -0,0 +1,176 @@
+#define _DEFAULT_SOURCE
+#include <stdatomic.h>
+#include <pthread.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include "escritor.h"
+#include "metricas.h"
+#include "transmissao.h"
+
+// Bit do índice do meio: o quadro pronto ainda não foi pego pela escrita
+#define QUADRO_NOVO 4u
+#define MASCARA_INDICE 3u
+
+// Buffer triplo entre o loop do jogo, que compõe, e a thread de escrita, que
+// envia ao terminal. Cada lado tem um quadro só seu e o terceiro fica no meio
+// com o último quadro pronto; as trocas são um atomic_exchange do índice do
+// meio, sem locks. Se o terminal estiver lento, um quadro novo substitui no
+// meio o que ainda não foi escrito, e o jogo nunca espera pela escrita
+typedef struct {
+    _Alignas(64) _Atomic uint32_t meio;
+    int producao;
+    uint64_t publicados;
+    uint64_t sequencias[NUM_QUADROS_TELA];
+    _Alignas(64) int escrita;
+    _Atomic uint64_t sequencia_escrita;
+    _Atomic uint64_t bytes_escritos;
+} BufferTriplo;
+
+static BufferTriplo triplo;
+static Tela *tela_escrita;
+static pthread_t thread_escritor;
+static int pipe_escritor[2] = { -1, -1 };
+static _Atomic int parar = 0;
+static int escritor_ativo = 0;
+
+static long long instante_atual_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Acorda a thread de escrita parada no poll(); o pipe nunca bloqueia
+static void acordar_escritor(void) {
+    char sinal = 1;
+    while (write(pipe_escritor[1], &sinal, 1) < 0 && errno == EINTR);
+}
+
+static void esvaziar_pipe(void) {
+    char descarte[64];
+    while (read(pipe_escritor[0], descarte, sizeof(descarte)) > 0);
+}
+
+// Thread de escrita: pega o quadro do meio sempre que há um novo, renderiza
+// só as diferenças para o último quadro enviado e repassa os mesmos bytes aos
+// espectadores da transmissão, se houver. Quadros publicados e
+// substituídos antes de serem pegos contam como coalescidos. Na parada, o
+// último quadro pronto ainda é escrito
+static void *executar_escritor(void *arg) {
+    (void)arg;
+    struct pollfd fd = { .fd = pipe_escritor[0], .events = POLLIN };
+    uint64_t ultima = atomic_load_explicit(&triplo.sequencia_escrita, memory_order_relaxed);
+    long long ultimo_fim = 0;
+    
+    while (1) {
+        if (!(atomic_load_explicit(&triplo.meio, memory_order_relaxed) & QUADRO_NOVO)) {
+            if (atomic_load_explicit(&parar, memory_order_acquire)) {
+                break;
+            }
+            // Um quadro publicado depois do teste acima deixa um byte no pipe
+            poll(&fd, 1, -1);
+            esvaziar_pipe();
+            continue;
+        }
+        
+        uint32_t anterior = atomic_exchange_explicit(&triplo.meio, (uint32_t)triplo.escrita,
+                                                     memory_order_acq_rel);
+        triplo.escrita = (int)(anterior & MASCARA_INDICE);
+        uint64_t sequencia = triplo.sequencias[triplo.escrita];
+        if (sequencia > ultima + 1) {
+            registrar_quadros_coalescidos(sequencia - ultima - 1);
+        }
+        ultima = sequencia;
+        
+        long long inicio = instante_atual_ns();
+        renderizar_quadro(tela_escrita, tela_escrita->quadros[triplo.escrita],
+                          tela_escrita->planos_atributos[triplo.escrita]);
+        transmitir_quadro(tela_escrita, tela_escrita->quadros[triplo.escrita],
+                          tela_escrita->planos_atributos[triplo.escrita]);
+        long long fim = instante_atual_ns();
+        
+        registrar_fase(FASE_ESCRITA, fim - inicio);
+        registrar_quadro_escrito(tela_escrita->bytes_quadro);
+        if (ultimo_fim > 0) {
+            registrar_fase(FASE_QUADRO, fim - ultimo_fim);
+        }
+        ultimo_fim = fim;
+        
+        atomic_store_explicit(&triplo.bytes_escritos, tela_escrita->bytes_quadro, memory_order_relaxed);
+        atomic_store_explicit(&triplo.sequencia_escrita, sequencia, memory_order_release);
+    }
+    return NULL;
+}
+
+// Inicia a thread de escrita da tela; a partir daqui a tela só pode ser
+// renderizada por ela, e o loop do jogo entrega quadros com publicar_quadro().
+// Retorna 0 em sucesso
+int iniciar_escritor(Tela *tela) {
+    if (pipe(pipe_escritor) != 0) {
+        return -1;
+    }
+    fcntl(pipe_escritor[0], F_SETFL, O_NONBLOCK);
+    fcntl(pipe_escritor[1], F_SETFL, O_NONBLOCK);
+    
+    // As sequências continuam entre telas, então um quadro da tela anterior
+    // nunca é confundido com um da nova
+    tela_escrita = tela;
+    triplo.producao = 0;
+    triplo.escrita = 1;
+    atomic_store_explicit(&triplo.meio, 2, memory_order_relaxed);
+    selecionar_quadro(tela, triplo.producao);
+    atomic_store_explicit(&parar, 0, memory_order_relaxed);
+    
+    if (pthread_create(&thread_escritor, NULL, executar_escritor, NULL) != 0) {
+        close(pipe_escritor[0]);
+        close(pipe_escritor[1]);
+        pipe_escritor[0] = pipe_escritor[1] = -1;
+        return -1;
+    }
+    escritor_ativo = 1;
+    return 0;
+}
+
+// Escreve o último quadro pronto, encerra a thread de escrita e devolve a
+// tela ao loop do jogo
+void parar_escritor(void) {
+    if (!escritor_ativo) {
+        return;
+    }
+    
+    atomic_store_explicit(&parar, 1, memory_order_release);
+    acordar_escritor();
+    pthread_join(thread_escritor, NULL);
+    close(pipe_escritor[0]);
+    close(pipe_escritor[1]);
+    pipe_escritor[0] = pipe_escritor[1] = -1;
+    escritor_ativo = 0;
+}
+
+// Entrega o quadro composto à thread de escrita e passa a compor no quadro
+// que estava no meio. Nunca bloqueia; só faz uma chamada de sistema quando a
+// escrita já tinha pego o quadro anterior e pode estar dormindo. Retorna o
+// número de sequência do quadro entregue
+uint64_t publicar_quadro(Tela *tela) {
+    uint64_t sequencia = ++triplo.publicados;
+    triplo.sequencias[triplo.producao] = sequencia;
+    
+    uint32_t anterior = atomic_exchange_explicit(&triplo.meio, (uint32_t)triplo.producao | QUADRO_NOVO,
+                                                 memory_order_acq_rel);
+    triplo.producao = (int)(anterior & MASCARA_INDICE);
+    selecionar_quadro(tela, triplo.producao);
+    
+    if (!(anterior & QUADRO_NOVO)) {
+        acordar_escritor();
+    }
+    return sequencia;
+}
+
+// O quadro `sequencia` (ou um mais novo) já chegou ao terminal e o último
+// escrito não mudou nenhuma célula
+int quadro_sem_mudancas(uint64_t sequencia) {
+    return atomic_load_explicit(&triplo.sequencia_escrita, memory_order_acquire) >= sequencia &&
+           atomic_load_explicit(&triplo.bytes_escritos, memory_order_relaxed) == 0;
+}
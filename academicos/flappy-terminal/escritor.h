@@ -0,0 +1,12 @@
+#ifndef ESCRITOR_H
+#define ESCRITOR_H
+
+#include <stdint.h>
+#include "tela.h"
+
+int iniciar_escritor(Tela *tela);
+void parar_escritor(void);
+uint64_t publicar_quadro(Tela *tela);
+int quadro_sem_mudancas(uint64_t sequencia);
+
+#endif
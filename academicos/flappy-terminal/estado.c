@@ -0,0 +1,118 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "estado.h"
+
+// Aloca o anel com espaço para SEGUNDOS_HISTORICO segundos no passo de
+// física mais curto. Retorna 0 em sucesso
+int inicializar_historico(Historico *historico) {
+    historico->capacidade = (int)(SEGUNDOS_HISTORICO * 1000000LL / FPS_DELAY_MINIMO) + 1;
+    historico->estados = malloc((size_t)historico->capacidade * sizeof(EstadoJogo));
+    limpar_historico(historico);
+    return historico->estados != NULL ? 0 : -1;
+}
+
+void liberar_historico(Historico *historico) {
+    free(historico->estados);
+    historico->estados = NULL;
+    historico->num = 0;
+}
+
+void limpar_historico(Historico *historico) {
+    historico->mais_recente = historico->capacidade - 1;
+    historico->num = 0;
+}
+
+// Guarda o estado atual da partida, descartando o mais antigo com o anel cheio
+void guardar_no_historico(Historico *historico, const Jogo *jogo) {
+    int indice = historico->mais_recente + 1;
+    if (indice == historico->capacidade) {
+        indice = 0;
+    }
+    salvar_estado(&historico->estados[indice], jogo);
+    historico->mais_recente = indice;
+    if (historico->num < historico->capacidade) {
+        historico->num++;
+    }
+}
+
+// Volta a partida pelo menos `microssegundos` de jogo (a duração do passo de
+// cada estado descartado), sem passar do estado mais antigo guardado. O
+// estado restaurado continua no anel como o mais recente. Retorna quantos
+// passos voltou
+int voltar_no_historico(Historico *historico, long long microssegundos, Jogo *jogo) {
+    int passos = 0;
+    long long voltado = 0;
+    
+    while (historico->num > 1 && voltado < microssegundos) {
+        voltado += historico->estados[historico->mais_recente].fps_delay_atual;
+        historico->mais_recente = historico->mais_recente > 0 ? historico->mais_recente - 1
+                                                                : historico->capacidade - 1;
+        historico->num--;
+        passos++;
+    }
+    if (passos > 0) {
+        restaurar_estado(jogo, &historico->estados[historico->mais_recente]);
+    }
+    return passos;
+}
+
+// Formato do arquivo de estado: "FBST", versão (1 byte + 3 reservados) e
+// sizeof(Jogo) em 4 bytes, seguidos do Jogo byte a byte. Ao contrário do
+// replay, o layout é o da máquina que salvou; o tamanho gravado recusa
+// arquivos de outra arquitetura ou versão do Jogo
+int salvar_estado_arquivo(const EstadoJogo *estado, const char *caminho) {
+    uint8_t cabecalho[ESTADO_TAMANHO_CABECALHO] = { 0 };
+    uint32_t tamanho = sizeof(EstadoJogo);
+    memcpy(cabecalho, ESTADO_MAGICA, 4);
+    cabecalho[4] = ESTADO_VERSAO;
+    memcpy(cabecalho + 8, &tamanho, sizeof(tamanho));
+    
+    FILE *arquivo = fopen(caminho, "wb");
+    if (arquivo == NULL) {
+        return -1;
+    }
+    int erro = fwrite(cabecalho, 1, sizeof(cabecalho), arquivo) != sizeof(cabecalho) ||
+               fwrite(estado, sizeof(EstadoJogo), 1, arquivo) != 1;
+    if (fclose(arquivo) != 0) {
+        erro = 1;
+    }
+    return erro ? -1 : 0;
+}
+
+// Lê um estado salvo e confere que ele descreve uma partida possível, já que
+// os índices dele são usados sem novas verificações. Retorna 0 ou -1
+int carregar_estado_arquivo(EstadoJogo *estado, const char *caminho) {
+    uint8_t cabecalho[ESTADO_TAMANHO_CABECALHO];
+    EstadoJogo lido;
+    uint32_t tamanho;
+    
+    FILE *arquivo = fopen(caminho, "rb");
+    if (arquivo == NULL) {
+        return -1;
+    }
+    int erro = fread(cabecalho, 1, sizeof(cabecalho), arquivo) != sizeof(cabecalho);
+    if (!erro) {
+        memcpy(&tamanho, cabecalho + 8, sizeof(tamanho));
+        erro = memcmp(cabecalho, ESTADO_MAGICA, 4) != 0 || cabecalho[4] != ESTADO_VERSAO ||
+               tamanho != sizeof(EstadoJogo) || fread(&lido, sizeof(lido), 1, arquivo) != 1;
+    }
+    fclose(arquivo);
+    if (erro) {
+        return -1;
+    }
+    
+    if (lido.largura < LARGURA_MINIMA || lido.largura > LARGURA_MAXIMA ||
+        lido.altura < ALTURA_MINIMA || lido.altura > ALTURA_MAXIMA ||
+        lido.capacidade_obstaculos != capacidade_para_largura(lido.largura) ||
+        lido.obstaculos.num < 0 || lido.obstaculos.num > lido.capacidade_obstaculos ||
+        lido.pontuacao < 0 || lido.passaro.nivel_evolucao != lido.pontuacao / PONTUACAO_PARA_PROXIMO_NIVEL ||
+        lido.causa_fim < FIM_NENHUM || lido.causa_fim >= NUM_CAUSAS_FIM || lido.quadros < 0 ||
+        lido.gerador.dificuldade < 0 || lido.gerador.dificuldade >= NUM_DIFICULDADES ||
+        lido.gerador.altura != lido.altura || lido.gerador.fim - lido.gerador.inicio > CAPACIDADE_GERADOR) {
+        return -1;
+    }
+    *estado = lido;
+    return 0;
+}
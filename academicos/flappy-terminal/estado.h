@@ -0,0 +1,42 @@
+#ifndef ESTADO_H
+#define ESTADO_H
+
+#include "jogo.h"
+
+#define ESTADO_MAGICA "FBST"
+#define ESTADO_VERSAO 2
+#define ESTADO_TAMANHO_CABECALHO 12
+#define SEGUNDOS_HISTORICO 10
+
+// Instantâneo de uma partida. O Jogo não tem ponteiros e já guarda tudo o
+// que decide o futuro (gerador, contador de obstáculos, quadro atual), então
+// o instantâneo é o próprio Jogo e salvar ou restaurar é uma cópia de
+// sizeof(Jogo) bytes
+typedef Jogo EstadoJogo;
+
+// Anel com os estados dos últimos SEGUNDOS_HISTORICO segundos de partida,
+// um por passo de física; `mais_recente` é o último estado guardado
+typedef struct {
+    EstadoJogo *estados;
+    int capacidade;
+    int mais_recente;
+    int num;
+} Historico;
+
+static inline void salvar_estado(EstadoJogo *estado, const Jogo *jogo) {
+    *estado = *jogo;
+}
+
+static inline void restaurar_estado(Jogo *jogo, const EstadoJogo *estado) {
+    *jogo = *estado;
+}
+
+int inicializar_historico(Historico *historico);
+void liberar_historico(Historico *historico);
+void limpar_historico(Historico *historico);
+void guardar_no_historico(Historico *historico, const Jogo *jogo);
+int voltar_no_historico(Historico *historico, long long microssegundos, Jogo *jogo);
+int salvar_estado_arquivo(const EstadoJogo *estado, const char *caminho);
+int carregar_estado_arquivo(EstadoJogo *estado, const char *caminho);
+
+#endif
@@ -1,50 +1,68 @@
+#define _DEFAULT_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
 #include <unistd.h>
 #include <termios.h>
 #include <time.h>
-#include <sys/select.h>
+#include <errno.h>
+#include <signal.h>
+#include <sys/ioctl.h>
+#include "jogo.h"
+#include "lote.h"
+#include "rede.h"
+#include "treino.h"
+#include "piloto.h"
+#include "replay.h"
+#include "tela.h"
+#include "metricas.h"
+#include "entrada.h"
+#include "escritor.h"
+#include "transmissao.h"
+#include "mundo.h"
+#include "placar.h"
+#include "estado.h"
 
-#define LARGURA_TELA 80
-#define ALTURA_TELA 20
-#define GRAVIDADE 0.1
-#define IMPULSO -0.3
-#define LARGURA_OBSTACULO 4
-#define VELOCIDADE_JOGO_BASE 1.0
-#define VELOCIDADE_JOGO_MAXIMA 2.0
-#define FPS_DELAY_BASE 33333
-#define FPS_DELAY_MINIMO 16666
-#define PONTUACAO_PARA_PROXIMO_NIVEL 2
-#define MODO_INVENCIVEL 0
+#define PASSOS_MAXIMOS_POR_QUADRO 5
+#define QUADROS_POR_SEGUNDO_PADRAO 60
+#define CAMINHO_REDE_PADRAO "rede.fbnn"
+#define CAMINHO_ESTADO_PADRAO "estado.fbst"
+#define REBOBINAR_POR_TECLA_US 250000
 
-typedef struct {
-    int x, y;
-    float velocidade;
-    char desenho[4][6];
-    int nivel_evolucao;
-} Passaro;
+// Tecla de pulo de cada jogador local no modo --birds
+static const char TECLAS_JOGADORES[MAX_JOGADORES] = { ' ', 'w', 'p', 'm' };
 
-typedef struct {
-    int x;
-    int altura_superior;
-    int altura_inferior;
-    int passou;
-} Obstaculo;
-
-typedef struct {
-    int largura, altura;
-    char **buffer;
-} Tela;
-
-Passaro passaro;
-Obstaculo obstaculos[3];
-int pontuacao = 0;
-int game_over = 0;
+Jogo jogo;
 int jogo_iniciado = 0;
 Tela tela;
-float velocidade_jogo_atual = VELOCIDADE_JOGO_BASE;
-int fps_delay_atual = FPS_DELAY_BASE;
+Mundo mundo;
+int modo_mundo = 0;
+Aleatorio aleatorio_partidas;
+Replay gravacao;
+const char *caminho_gravacao = NULL;
+Replay reproducao;
+int reproduzindo = 0;
+uint32_t cursor_reproducao = 0;
+Historico historico;
+int partida_rebobinada = 0;
+const char *caminho_estado = CAMINHO_ESTADO_PADRAO;
+int estado_salvo = 0;
+Rede rede_piloto;
+int piloto_rede = 0;
+Piloto piloto_busca;
+int usar_piloto_busca = 0;
+int largura_campo = LARGURA_TELA;
+int altura_campo = ALTURA_TELA;
+int tamanho_fixo = 0;
+int dificuldade = DIFICULDADE_CLASSICA;
+volatile sig_atomic_t tamanho_mudou = 0;
+int sair = 0;
+#ifdef DEBUG
+int mostrar_hud = 1;
+#else
+int mostrar_hud = 0;
+#endif
 
 // Configura o terminal para leitura de teclas sem pressionar Enter
 void configurar_terminal() {
@@ -80,574 +98,939 @@ void mostrar_cursor() {
     fflush(stdout);
 }
 
-// Aloca memória para o buffer da tela e inicializa com espaços
-void inicializar_tela() {
-    tela.largura = LARGURA_TELA;
-    tela.altura = ALTURA_TELA;
-    tela.buffer = malloc(ALTURA_TELA * sizeof(char*));
+// Sinaliza ao loop principal que o terminal mudou de tamanho (SIGWINCH)
+void ao_redimensionar(int sinal) {
+    (void)sinal;
+    tamanho_mudou = 1;
+    acordar_loop();
+}
+
+// Lê o tamanho atual do terminal, limitado ao intervalo suportado pelo jogo
+void obter_tamanho_terminal(int *largura, int *altura) {
+    struct winsize ws;
     
-    for (int i = 0; i < ALTURA_TELA; i++) {
-        tela.buffer[i] = malloc((LARGURA_TELA + 1) * sizeof(char));
-        memset(tela.buffer[i], ' ', LARGURA_TELA);
-        tela.buffer[i][LARGURA_TELA] = '\0';
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_col > 0 && ws.ws_row > 0) {
+        *largura = ws.ws_col;
+        *altura = ws.ws_row;
     }
+    
+    if (*largura < LARGURA_MINIMA) *largura = LARGURA_MINIMA;
+    if (*largura > LARGURA_MAXIMA) *largura = LARGURA_MAXIMA;
+    if (*altura < ALTURA_MINIMA) *altura = ALTURA_MINIMA;
+    if (*altura > ALTURA_MAXIMA) *altura = ALTURA_MAXIMA;
 }
 
-// Libera a memória alocada para o buffer da tela
-void liberar_tela() {
-    for (int i = 0; i < ALTURA_TELA; i++) {
-        free(tela.buffer[i]);
+// Aplica um novo tamanho de terminal: para a thread de escrita, realoca o
+// framebuffer uma única vez por mudança e ajusta o campo da partida em
+// andamento. Retorna 0 em sucesso
+int aplicar_novo_tamanho(Jogo *jogo) {
+    int largura = largura_campo;
+    int altura = altura_campo;
+    
+    tamanho_mudou = 0;
+    obter_tamanho_terminal(&largura, &altura);
+    if (largura == largura_campo && altura == altura_campo) {
+        return 0;
+    }
+    
+    int unicode = tela.unicode;
+    int cores = tela.cores;
+    parar_escritor();
+    liberar_tela(&tela);
+    if (inicializar_tela(&tela, largura, altura) != 0) {
+        return -1;
+    }
+    tela.unicode = unicode;
+    if (cores) {
+        ativar_cores(&tela);
+    }
+    if (iniciar_escritor(&tela) != 0) {
+        return -1;
+    }
+    largura_campo = largura;
+    altura_campo = altura;
+    if (modo_mundo) {
+        redimensionar_mundo(&mundo, largura, altura);
+    } else {
+        redimensionar_jogo(jogo, largura, altura);
     }
-    free(tela.buffer);
+    return 0;
 }
 
-// Limpa o buffer da tela preenchendo com espaços
-void limpar_buffer() {
-    for (int i = 0; i < ALTURA_TELA; i++) {
-        memset(tela.buffer[i], ' ', LARGURA_TELA);
+// Começa uma nova partida: no modo replay usa a semente gravada, senão sorteia
+// uma nova e, se estiver gravando, reinicia a gravação
+void nova_partida(Jogo *jogo) {
+    if (reproduzindo) {
+        inicializar_jogo(jogo, reproducao.semente, reproducao.largura, reproducao.altura,
+                         reproducao.dificuldade);
+        cursor_reproducao = 0;
+        return;
+    }
+    
+    uint64_t semente = ((uint64_t)proximo_aleatorio(&aleatorio_partidas) << 32) |
+                       proximo_aleatorio(&aleatorio_partidas);
+    if (modo_mundo) {
+        reiniciar_mundo(&mundo, semente);
+        return;
+    }
+    inicializar_jogo(jogo, semente, largura_campo, altura_campo, dificuldade);
+    if (caminho_gravacao != NULL) {
+        iniciar_replay(&gravacao, jogo);
     }
+    limpar_historico(&historico);
+    guardar_no_historico(&historico, jogo);
+    partida_rebobinada = 0;
 }
 
-// Desenha as bordas do jogo (superior, inferior e laterais)
-void desenhar_borda() {
-    for (int x = 0; x < LARGURA_TELA; x++) {
-        tela.buffer[0][x] = '-';
-        tela.buffer[ALTURA_TELA-1][x] = '-';
+// Decisão de pulo da política automática: a rede de --net, a busca de
+// --autopilot ou, sem nenhuma das duas, a política do vão
+int decidir_automatico(const Jogo *jogo) {
+    if (piloto_rede) {
+        return decidir_rede(&rede_piloto, jogo);
     }
-    
-    for (int y = 0; y < ALTURA_TELA; y++) {
-        tela.buffer[y][0] = '|';
-        tela.buffer[y][LARGURA_TELA-1] = '|';
+    if (usar_piloto_busca) {
+        return decidir_piloto(&piloto_busca, jogo);
     }
+    return politica_seguir_vao(jogo);
 }
 
-// Inicializa o desenho do pássaro com apenas um '#' no nível 0
-void inicializar_desenho_passaro() {
-    for (int i = 0; i < 4; i++) {
-        for (int j = 0; j < 6; j++) {
-            passaro.desenho[i][j] = ' ';
+// Avança um passo de física da partida interativa, aplicando os pulos do
+// replay e salvando a gravação e o placar quando a partida termina
+void avancar_partida(Jogo *jogo) {
+    if (reproduzindo && pulo_no_quadro(&reproducao, &cursor_reproducao, (uint32_t)jogo->quadros)) {
+        pular(jogo);
+    } else if (!reproduzindo && (piloto_rede || usar_piloto_busca) && decidir_automatico(jogo)) {
+        pular(jogo);
+        if (caminho_gravacao != NULL) {
+            registrar_pulo(&gravacao, (uint32_t)jogo->quadros);
         }
     }
     
-    passaro.desenho[3][1] = '#';
-    passaro.nivel_evolucao = 0;
-}
-
-// Calcula o delay do FPS baseado na evolução do pássaro para acelerar o jogo
-void calcular_fps_delay() {
-    int nivel_atual = pontuacao / PONTUACAO_PARA_PROXIMO_NIVEL;
+    avancar_jogo(jogo);
     
-    if (nivel_atual >= 12) {
-        int pontos_apos_completo = pontuacao - 12;
-        int decrementos = pontos_apos_completo / 2;
-        
-        fps_delay_atual = FPS_DELAY_BASE - (decrementos * 1000);
-        
-        if (fps_delay_atual < FPS_DELAY_MINIMO) {
-            fps_delay_atual = FPS_DELAY_MINIMO;
-        }
-    } else {
-        fps_delay_atual = FPS_DELAY_BASE;
+    if (reproduzindo && (uint32_t)jogo->quadros >= reproducao.quadros) {
+        encerrar_jogo(jogo, jogo->causa_fim);
+    }
+    if (!reproduzindo) {
+        guardar_no_historico(&historico, jogo);
+    }
+    if (jogo->game_over && caminho_gravacao != NULL) {
+        finalizar_replay(&gravacao, jogo);
+        salvar_replay(&gravacao, caminho_gravacao);
+    }
+    if (jogo->game_over && !reproduzindo && !partida_rebobinada) {
+        registrar_partida_placar(piloto_rede || usar_piloto_busca ? ORIGEM_PILOTO : ORIGEM_JOGADOR, jogo);
     }
 }
 
-// Atualiza o desenho do pássaro baseado na pontuação (evolução progressiva)
-void atualizar_desenho_passaro() {
-    int novo_nivel = pontuacao / PONTUACAO_PARA_PROXIMO_NIVEL;
-    
-    if (novo_nivel != passaro.nivel_evolucao) {
-        passaro.nivel_evolucao = novo_nivel;
-        
-        for (int i = 0; i < 4; i++) {
-            for (int j = 0; j < 6; j++) {
-                passaro.desenho[i][j] = ' ';
-            }
-        }
-        
-        if (passaro.nivel_evolucao >= 0) {
-            passaro.desenho[3][1] = '#';
-        }
-        if (passaro.nivel_evolucao >= 1) {
-            passaro.desenho[3][1] = '#';
-            passaro.desenho[3][2] = '#';
-        }
-        if (passaro.nivel_evolucao >= 2) {
-            passaro.desenho[3][1] = '#';
-            passaro.desenho[3][2] = '#';
-            passaro.desenho[3][3] = '#';
-        }
-        if (passaro.nivel_evolucao >= 3) {
-            passaro.desenho[3][1] = '#';
-            passaro.desenho[3][2] = '#';
-            passaro.desenho[3][3] = '#';
-            passaro.desenho[2][0] = '#';
-        }
-        if (passaro.nivel_evolucao >= 4) {
-            passaro.desenho[3][1] = '#';
-            passaro.desenho[3][2] = '#';
-            passaro.desenho[3][3] = '#';
-            passaro.desenho[2][0] = '#';
-            passaro.desenho[2][1] = '#';
-        }
-        if (passaro.nivel_evolucao >= 5) {
-            passaro.desenho[3][1] = '#';
-            passaro.desenho[3][2] = '#';
-            passaro.desenho[3][3] = '#';
-            passaro.desenho[2][0] = '#';
-            passaro.desenho[2][1] = '#';
-            passaro.desenho[2][2] = '#';
-        }
-        if (passaro.nivel_evolucao >= 6) {
-            passaro.desenho[3][1] = '#';
-            passaro.desenho[3][2] = '#';
-            passaro.desenho[3][3] = '#';
-            passaro.desenho[2][0] = '#';
-            passaro.desenho[2][1] = '#';
-            passaro.desenho[2][2] = '#';
-            passaro.desenho[2][3] = '#';
-        }
-        if (passaro.nivel_evolucao >= 7) {
-            passaro.desenho[3][1] = '#';
-            passaro.desenho[3][2] = '#';
-            passaro.desenho[3][3] = '#';
-            passaro.desenho[2][0] = '#';
-            passaro.desenho[2][1] = '#';
-            passaro.desenho[2][2] = '#';
-            passaro.desenho[2][3] = '#';
-            passaro.desenho[1][1] = '#';
-        }
-        if (passaro.nivel_evolucao >= 8) {
-            passaro.desenho[3][1] = '#';
-            passaro.desenho[3][2] = '#';
-            passaro.desenho[3][3] = '#';
-            passaro.desenho[2][0] = '#';
-            passaro.desenho[2][1] = '#';
-            passaro.desenho[2][2] = '#';
-            passaro.desenho[2][3] = '#';
-            passaro.desenho[1][1] = '#';
-            passaro.desenho[1][2] = '#';
-        }
-        if (passaro.nivel_evolucao >= 9) {
-            passaro.desenho[3][1] = '#';
-            passaro.desenho[3][2] = '#';
-            passaro.desenho[3][3] = '#';
-            passaro.desenho[2][0] = '#';
-            passaro.desenho[2][1] = '#';
-            passaro.desenho[2][2] = '#';
-            passaro.desenho[2][3] = '#';
-            passaro.desenho[1][1] = '#';
-            passaro.desenho[1][2] = '#';
-            passaro.desenho[1][3] = '#';
-        }
-        if (passaro.nivel_evolucao >= 10) {
-            passaro.desenho[3][1] = '#';
-            passaro.desenho[3][2] = '#';
-            passaro.desenho[3][3] = '#';
-            passaro.desenho[2][0] = '#';
-            passaro.desenho[2][1] = '#';
-            passaro.desenho[2][2] = '#';
-            passaro.desenho[2][3] = '#';
-            passaro.desenho[1][1] = '#';
-            passaro.desenho[1][2] = '#';
-            passaro.desenho[1][3] = '#';
-            passaro.desenho[0][1] = '#';
-        }
-        if (passaro.nivel_evolucao >= 11) {
-            passaro.desenho[3][1] = '#';
-            passaro.desenho[3][2] = '#';
-            passaro.desenho[3][3] = '#';
-            passaro.desenho[2][0] = '#';
-            passaro.desenho[2][1] = '#';
-            passaro.desenho[2][2] = '#';
-            passaro.desenho[2][3] = '#';
-            passaro.desenho[1][1] = '#';
-            passaro.desenho[1][2] = '#';
-            passaro.desenho[1][3] = '#';
-            passaro.desenho[0][1] = '#';
-            passaro.desenho[0][2] = '#';
-        }
-        if (passaro.nivel_evolucao >= 12) {
-            passaro.desenho[3][1] = '#';
-            passaro.desenho[3][2] = '#';
-            passaro.desenho[3][3] = '#';
-            passaro.desenho[2][0] = '#';
-            passaro.desenho[2][1] = '#';
-            passaro.desenho[2][2] = '#';
-            passaro.desenho[2][3] = '#';
-            passaro.desenho[1][1] = '#';
-            passaro.desenho[1][2] = '#';
-            passaro.desenho[1][3] = '#';
-            passaro.desenho[0][1] = '#';
-            passaro.desenho[0][2] = '#';
-            passaro.desenho[0][3] = '>';
-        }
+// Volta a partida REBOBINAR_POR_TECLA_US no tempo, inclusive depois do game
+// over. A gravação esquece os pulos desfeitos e a partida deixa de contar
+// para o placar
+void rebobinar_partida(Jogo *jogo) {
+    if (voltar_no_historico(&historico, REBOBINAR_POR_TECLA_US, jogo) == 0) {
+        return;
+    }
+    partida_rebobinada = 1;
+    if (jogo->largura != largura_campo || jogo->altura != altura_campo) {
+        redimensionar_jogo(jogo, largura_campo, altura_campo);
+    }
+    if (caminho_gravacao != NULL) {
+        descartar_pulos_desde(&gravacao, (uint32_t)jogo->quadros);
     }
 }
 
-// Inicializa todas as variáveis do jogo para um novo jogo
-void inicializar_jogo() {
-    passaro.x = 10;
-    passaro.y = ALTURA_TELA / 2;
-    passaro.velocidade = 0;
-    inicializar_desenho_passaro();
-    
-    srand(time(NULL));
-    for (int i = 0; i < 3; i++) {
-        obstaculos[i].x = LARGURA_TELA + (i * 25);
-        int espaco_obstaculos = 8;
-        int altura_maxima_superior = ALTURA_TELA - espaco_obstaculos - 2;
-        obstaculos[i].altura_superior = rand() % altura_maxima_superior + 1;
-        obstaculos[i].altura_inferior = ALTURA_TELA - obstaculos[i].altura_superior - espaco_obstaculos;
-        obstaculos[i].passou = 0;
-    }
-    
-    pontuacao = 0;
-    game_over = 0;
-    velocidade_jogo_atual = VELOCIDADE_JOGO_BASE;
-    fps_delay_atual = FPS_DELAY_BASE;
+// A partida, ou a rodada do modo --birds, terminou
+int partida_encerrada(const Jogo *jogo) {
+    return modo_mundo ? mundo.game_over : jogo->game_over;
 }
 
-// Desenha o pássaro no buffer da tela usando seu desenho ASCII
-void desenhar_passaro() {
-    for (int i = 0; i < 4; i++) {
-        for (int j = 0; j < 6; j++) {
-            int y = passaro.y - 1 + i;
-            int x = passaro.x - 2 + j;
-            
-            if (y >= 1 && y < ALTURA_TELA-1 && 
-                x >= 1 && x < LARGURA_TELA-1 && 
-                passaro.desenho[i][j] != ' ') {
-                tela.buffer[y][x] = passaro.desenho[i][j];
-            }
-        }
-    }
+// Duração do passo de física atual, em microssegundos
+int delay_atual(const Jogo *jogo) {
+    return modo_mundo ? mundo.fps_delay_atual : jogo->fps_delay_atual;
 }
 
-// Desenha todos os obstáculos (superior e inferior) no buffer da tela
-void desenhar_obstaculos() {
-    for (int i = 0; i < 3; i++) {
-        if (obstaculos[i].x >= 0 && obstaculos[i].x < LARGURA_TELA) {
-            for (int y = 1; y < obstaculos[i].altura_superior; y++) {
-                for (int x = obstaculos[i].x; x < obstaculos[i].x + LARGURA_OBSTACULO && x < LARGURA_TELA-1; x++) {
-                    if (x >= 1) {
-                        tela.buffer[y][x] = '|';
-                    }
-                }
-            }
-            
-            for (int y = ALTURA_TELA - obstaculos[i].altura_inferior; y < ALTURA_TELA-1; y++) {
-                for (int x = obstaculos[i].x; x < obstaculos[i].x + LARGURA_OBSTACULO && x < LARGURA_TELA-1; x++) {
-                    if (x >= 1) {
-                        tela.buffer[y][x] = '|';
-                    }
-                }
-            }
-        }
-    }
+// Avança um passo de física da rodada do modo --birds: os robôs decidem
+// juntos e o mundo avança todos os pássaros de uma vez
+void avancar_rodada(void) {
+    pular_robos(&mundo);
+    avancar_mundo(&mundo);
 }
 
-// Aplica a física do pássaro (gravidade e movimento) e verifica colisões com bordas
-void atualizar_passaro() {
-    passaro.velocidade += GRAVIDADE;
-    passaro.y += passaro.velocidade;
+// Processa uma tecla no modo --birds: cada jogador pula com a sua tecla, e
+// uma nova rodada pode começar assim que nenhum jogador estiver vivo
+void processar_tecla_mundo(Jogo *jogo, char tecla) {
+    tecla = (char)tolower((unsigned char)tecla);
+    int jogadores_vivos = 0;
+    for (int i = 0; i < mundo.num_jogadores; i++) {
+        jogadores_vivos |= passaro_vivo(&mundo.passaros, i);
+    }
     
-#if !MODO_INVENCIVEL
-    if (passaro.nivel_evolucao == 0) {
-        if (passaro.y <= 0 || passaro.y >= ALTURA_TELA-1) {
-            game_over = 1;
+    if (!jogo_iniciado) {
+        if (tecla == ' ') {
+            jogo_iniciado = 1;
         }
-    } else if (passaro.nivel_evolucao <= 2) {
-        if (passaro.y <= 0 || passaro.y >= ALTURA_TELA-1) {
-            game_over = 1;
+        return;
+    }
+    if (!mundo.game_over) {
+        for (int i = 0; i < mundo.num_jogadores; i++) {
+            if (tecla == TECLAS_JOGADORES[i]) {
+                pular_passaro(&mundo, i);
+            }
         }
-    } else if (passaro.nivel_evolucao <= 6) {
-        if (passaro.y <= 0 || passaro.y + 1 >= ALTURA_TELA-1) {
-            game_over = 1;
+    }
+    if (mundo.game_over || !jogadores_vivos) {
+        if (tecla == 'r') {
+            nova_partida(jogo);
         }
-    } else {
-        if (passaro.y - 1 <= 0 || passaro.y + 2 >= ALTURA_TELA-1) {
-            game_over = 1;
+        if (tecla == 'q') {
+            sair = 1;
         }
     }
-#endif
 }
 
-// Move os obstáculos, calcula FPS delay, pontuação e verifica colisões
-void atualizar_obstaculos() {
-    static int contador = 0;
-    contador++;
-    
-    calcular_fps_delay();
+// Processa uma tecla baseado no estado do jogo
+void processar_tecla(Jogo *jogo, char tecla) {
+    if (tecla == 'h' || tecla == 'H') {
+        mostrar_hud = !mostrar_hud;
+        return;
+    }
+    if (modo_mundo) {
+        processar_tecla_mundo(jogo, tecla);
+        return;
+    }
     
-    if (contador >= 2) {
-        contador = 0;
-        for (int i = 0; i < 3; i++) {
-            obstaculos[i].x -= 1;
-        }
+    if (jogo_iniciado && !reproduzindo && (tecla == 'v' || tecla == 'V')) {
+        rebobinar_partida(jogo);
+        return;
+    }
+    if (jogo_iniciado && (tecla == 'e' || tecla == 'E')) {
+        estado_salvo = salvar_estado_arquivo(jogo, caminho_estado) == 0;
+        return;
     }
     
-    for (int i = 0; i < 3; i++) {
-        if (obstaculos[i].x + LARGURA_OBSTACULO < passaro.x && !obstaculos[i].passou) {
-            pontuacao++;
-            obstaculos[i].passou = 1;
+    if (!jogo_iniciado) {
+        if (tecla == ' ') {
+            jogo_iniciado = 1;
         }
-        
-        if (obstaculos[i].x + LARGURA_OBSTACULO < 0) {
-            obstaculos[i].x = LARGURA_TELA + 10;
-            int espaco_obstaculos = 8;
-            int altura_maxima_superior = ALTURA_TELA - espaco_obstaculos - 2;
-            obstaculos[i].altura_superior = rand() % altura_maxima_superior + 1;
-            obstaculos[i].altura_inferior = ALTURA_TELA - obstaculos[i].altura_superior - espaco_obstaculos;
-            obstaculos[i].passou = 0;
+    } else if (!jogo->game_over) {
+        if (tecla == ' ' && !reproduzindo) {
+            pular(jogo);
+            if (caminho_gravacao != NULL) {
+                registrar_pulo(&gravacao, (uint32_t)jogo->quadros);
+            }
         }
-        
-        int passaro_left, passaro_right, passaro_top, passaro_bottom;
-        
-        if (passaro.nivel_evolucao == 0) {
-            passaro_left = passaro.x;
-            passaro_right = passaro.x;
-            passaro_top = passaro.y;
-            passaro_bottom = passaro.y;
-        } else if (passaro.nivel_evolucao <= 2) {
-            passaro_left = passaro.x - 1;
-            passaro_right = passaro.x + 1;
-            passaro_top = passaro.y;
-            passaro_bottom = passaro.y;
-        } else if (passaro.nivel_evolucao <= 6) {
-            passaro_left = passaro.x - 1;
-            passaro_right = passaro.x + 2;
-            passaro_top = passaro.y;
-            passaro_bottom = passaro.y + 1;
-        } else {
-            passaro_left = passaro.x - 2;
-            passaro_right = passaro.x + 3;
-            passaro_top = passaro.y - 1;
-            passaro_bottom = passaro.y + 2;
+    } else {
+        if (tecla == 'r' || tecla == 'R') {
+            nova_partida(jogo);
+            jogo_iniciado = 1;
         }
-        
-        if (passaro_right >= obstaculos[i].x && passaro_left < obstaculos[i].x + LARGURA_OBSTACULO) {
-            if (passaro_bottom >= 1 && passaro_top <= obstaculos[i].altura_superior - 1) {
-#if !MODO_INVENCIVEL
-                game_over = 1;
-#endif
-            }
-            int obstaculo_inferior_top = ALTURA_TELA - obstaculos[i].altura_inferior;
-            if (passaro_top <= ALTURA_TELA - 2 && passaro_bottom >= obstaculo_inferior_top) {
-#if !MODO_INVENCIVEL
-                game_over = 1;
-#endif
-            }
+        if (tecla == 'q' || tecla == 'Q') {
+            sair = 1;
         }
     }
 }
 
-// Desenha a interface do jogo (pontuação, menu inicial, game over)
-void desenhar_interface() {
-    char pontuacao_str[60];
-#if MODO_INVENCIVEL
-    int fps_atual = 1000000 / fps_delay_atual;
-    snprintf(pontuacao_str, sizeof(pontuacao_str), "Score: %d | Nivel: %d | FPS: %d | [INVENCIVEL]", 
-             pontuacao, passaro.nivel_evolucao, fps_atual);
+// Aplica, em ordem, as teclas lidas pela thread de entrada até o fim do
+// próximo passo de física; teclas mais novas esperam o passo correspondente
+void processar_entrada(Jogo *jogo, long long instante_simulado, long long agora) {
+    EventoTecla evento;
+    
+    while (retirar_tecla_ate(instante_simulado, &evento)) {
+        registrar_fase(FASE_LATENCIA_ENTRADA, agora - evento.instante_ns);
+        processar_tecla(jogo, evento.tecla);
+    }
+}
+
+// Retorna o tempo monotônico atual em nanossegundos
+long long agora_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Dorme até um instante absoluto do relógio monotônico, sem acumular atraso
+void dormir_ate(long long instante_ns) {
+#ifdef __APPLE__
+    long long restante = instante_ns - agora_ns();
+    if (restante <= 0) return;
+    struct timespec ts = { restante / 1000000000LL, restante % 1000000000LL };
+    while (nanosleep(&ts, &ts) == -1 && errno == EINTR);
 #else
-    snprintf(pontuacao_str, sizeof(pontuacao_str), "Score: %d", 
-             pontuacao);
+    struct timespec ts = { instante_ns / 1000000000LL, instante_ns % 1000000000LL };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR);
 #endif
+}
+
+// Simula o jogo sem terminal, desenho ou pausas, o mais rápido possível,
+// usando a política automática (ou a rede de --net, ou a busca de
+// --autopilot) e reiniciando a cada game over
+void executar_headless(long total_quadros, uint64_t semente, int largura, int altura) {
+    Jogo sim;
+    long partidas = 0;
+    long soma_pontuacao = 0;
+    int maior_pontuacao = 0;
     
-    int len = strlen(pontuacao_str);
-    int start_x = (LARGURA_TELA - len) / 2;
+    inicializar_jogo(&sim, semente, largura, altura, dificuldade);
+    long long inicio = agora_ns();
     
-    for (int i = 0; i < len; i++) {
-        if (start_x + i < LARGURA_TELA-1) {
-            tela.buffer[2][start_x + i] = pontuacao_str[i];
-        }
-    }
-    
-    if (!jogo_iniciado) {
-        char titulo[] = "=== FLAPPY TERMINAL ===";
-        int len_titulo = strlen(titulo);
-        int start_titulo = (LARGURA_TELA - len_titulo) / 2;
-        
-        for (int i = 0; i < len_titulo; i++) {
-            if (start_titulo + i < LARGURA_TELA-1) {
-                tela.buffer[4][start_titulo + i] = titulo[i];
-            }
+    for (long q = 0; q < total_quadros; q++) {
+        if (decidir_automatico(&sim)) {
+            pular(&sim);
         }
+        avancar_jogo(&sim);
         
-        char controles1[] = "Controles:";
-        int len_cont1 = strlen(controles1);
-        int start_cont1 = (LARGURA_TELA - len_cont1) / 2;
-        
-        for (int i = 0; i < len_cont1; i++) {
-            if (start_cont1 + i < LARGURA_TELA-1) {
-                tela.buffer[6][start_cont1 + i] = controles1[i];
+        if (sim.game_over) {
+            registrar_partida_placar(ORIGEM_SIMULACAO, &sim);
+            partidas++;
+            soma_pontuacao += sim.pontuacao;
+            if (sim.pontuacao > maior_pontuacao) {
+                maior_pontuacao = sim.pontuacao;
             }
+            inicializar_jogo(&sim, misturar_semente(semente, partidas), largura, altura, dificuldade);
         }
+    }
+    
+    double segundos = (agora_ns() - inicio) / 1e9;
+    
+    printf("quadros: %ld\n", total_quadros);
+    printf("partidas concluidas: %ld\n", partidas);
+    printf("pontuacao media: %.2f\n", partidas > 0 ? (double)soma_pontuacao / partidas : 0.0);
+    printf("maior pontuacao: %d\n", maior_pontuacao);
+    printf("partida em andamento: %ld quadros, pontuacao %d\n", sim.quadros, sim.pontuacao);
+    printf("tempo: %.3f s (%.0f quadros/s)\n", segundos,
+           segundos > 0 ? total_quadros / segundos : 0.0);
+    printf("kernel de obstaculos: %s\n", kernel_obstaculos());
+    if (usar_piloto_busca && piloto_busca.decisoes > 0) {
+        printf("piloto: horizonte %d, %.2f us por decisao, %.1f nos por decisao, %.1f%% acertos na tabela\n",
+               piloto_busca.horizonte, segundos * 1e6 / piloto_busca.decisoes,
+               (double)piloto_busca.nos / piloto_busca.decisoes,
+               100.0 * piloto_busca.acertos / (piloto_busca.acertos + piloto_busca.nos));
+    }
+}
+
+// Simula o modo --birds sem terminal, só com robôs, reiniciando a rodada
+// quando não sobra nenhum pássaro, e mede o custo de um quadro do mundo
+// inteiro. Retorna 0 em sucesso
+int executar_headless_mundo(long total_quadros, uint64_t semente, int largura, int altura, int num_passaros) {
+    Mundo sim;
+    long rodadas = 0;
+    long soma_pontuacao = 0;
+    int maior_pontuacao = 0;
+    long long soma_vivos = 0;
+    
+    if (inicializar_mundo(&sim, num_passaros, 0, semente, largura, altura, dificuldade) != 0) {
+        return -1;
+    }
+    long long inicio = agora_ns();
+    
+    for (long q = 0; q < total_quadros; q++) {
+        soma_vivos += sim.num_vivos;
+        pular_robos(&sim);
+        avancar_mundo(&sim);
         
-        char controles2[] = "ESPACO - Pular / Iniciar jogo";
-        int len_cont2 = strlen(controles2);
-        int start_cont2 = (LARGURA_TELA - len_cont2) / 2;
-        
-        for (int i = 0; i < len_cont2; i++) {
-            if (start_cont2 + i < LARGURA_TELA-1) {
-                tela.buffer[7][start_cont2 + i] = controles2[i];
+        if (sim.game_over) {
+            rodadas++;
+            soma_pontuacao += sim.pontuacao;
+            if (sim.pontuacao > maior_pontuacao) {
+                maior_pontuacao = sim.pontuacao;
             }
+            reiniciar_mundo(&sim, misturar_semente(semente, rodadas));
         }
-        
-        char controles3[] = "R - Reiniciar (apos game over)";
-        int len_cont3 = strlen(controles3);
-        int start_cont3 = (LARGURA_TELA - len_cont3) / 2;
-        
-        for (int i = 0; i < len_cont3; i++) {
-            if (start_cont3 + i < LARGURA_TELA-1) {
-                tela.buffer[8][start_cont3 + i] = controles3[i];
+    }
+    
+    long long ns = agora_ns() - inicio;
+    double segundos = ns / 1e9;
+    
+    printf("passaros: %d\n", num_passaros);
+    printf("quadros: %ld\n", total_quadros);
+    printf("rodadas concluidas: %ld\n", rodadas);
+    printf("pontuacao media do ultimo sobrevivente: %.2f\n", rodadas > 0 ? (double)soma_pontuacao / rodadas : 0.0);
+    printf("maior pontuacao: %d\n", maior_pontuacao);
+    printf("rodada em andamento: %ld quadros, pontuacao %d, %d vivos\n", sim.quadros, sim.pontuacao,
+           sim.num_vivos);
+    printf("tempo: %.3f s (%.0f quadros/s)\n", segundos, segundos > 0 ? total_quadros / segundos : 0.0);
+    printf("custo por quadro: %.0f ns | por passaro vivo: %.2f ns (%.1f vivos por quadro)\n",
+           total_quadros > 0 ? (double)ns / total_quadros : 0.0,
+           soma_vivos > 0 ? (double)ns / soma_vivos : 0.0,
+           total_quadros > 0 ? (double)soma_vivos / total_quadros : 0.0);
+    printf("kernel de obstaculos: %s\n", kernel_obstaculos());
+    liberar_mundo(&sim);
+    return 0;
+}
+
+// Reproduz uma gravação sem terminal e compara com o resultado gravado;
+// retorna 0 se a partida terminou igual, 1 se divergiu
+int verificar_replay(const Replay *replay) {
+    Jogo sim;
+    long long inicio = agora_ns();
+    reproduzir_replay(replay, &sim);
+    double segundos = (agora_ns() - inicio) / 1e9;
+    
+    int igual = sim.game_over && (uint32_t)sim.quadros == replay->quadros &&
+                sim.pontuacao == replay->pontuacao;
+    
+    printf("semente: %llu\n", (unsigned long long)replay->semente);
+    printf("pulos: %u\n", replay->num_pulos);
+    printf("gravado: %u quadros, pontuacao %d\n", replay->quadros, replay->pontuacao);
+    printf("reproduzido: %ld quadros, pontuacao %d%s\n", sim.quadros, sim.pontuacao,
+           sim.game_over ? "" : " (sem game over)");
+    printf("resultado: %s\n", igual ? "igual" : "DIVERGIU");
+    printf("tempo: %.6f s\n", segundos);
+    return igual ? 0 : 1;
+}
+
+// Mostra as opções de linha de comando
+void mostrar_uso(const char *programa) {
+    fprintf(stderr,
+            "Uso: %s [opcoes]\n"
+            "  --headless [quadros]   simula sem terminal, o mais rapido possivel\n"
+            "  --batch N              simula N partidas em paralelo e mostra estatisticas\n"
+            "  --threads T            threads do modo --batch (padrao: numero de nucleos)\n"
+            "  --policy gap|random    politica de pulo do modo --batch (padrao: gap)\n"
+            "  --prob P               random: chance de pular por quadro; gap: chance de errar\n"
+            "  --max-frames F         limite de quadros por partida no modo --batch (e no --train,\n"
+            "                         padrao 20000)\n"
+            "  --train G              treina redes por G geracoes de neuroevolucao e salva a melhor\n"
+            "  --population N         redes por geracao do --train (padrao 256)\n"
+            "  --episodes E           partidas por rede e geracao do --train (padrao 4)\n"
+            "  --net ARQUIVO          rede salva pelo --train (padrao " CAMINHO_REDE_PADRAO "); sem\n"
+            "                         --train, a rede joga sozinha (piloto automatico)\n"
+            "  --autopilot [K]        joga sozinho buscando pulos nos proximos K quadros com a\n"
+            "                         fisica real (padrao %d); tambem no --headless e no --batch\n"
+            "  --seed S               semente inicial (padrao: relogio)\n"
+            "  --difficulty D         curvas de vao, espacamento e variacao dos obstaculos:\n"
+            "                         classic (padrao), easy, hard ou ramp\n"
+            "  --width L / --height A tamanho fixo do campo (padrao: tamanho do terminal,\n"
+            "                         ou 80x20 nos modos sem terminal)\n"
+            "  --record ARQUIVO       grava a ultima partida (semente e pulos) em ARQUIVO; o campo\n"
+            "                         fica no tamanho inicial do terminal\n"
+            "  --replay ARQUIVO       reproduz uma gravacao; com --headless, verifica sem terminal\n"
+            "  --fps N                quadros desenhados por segundo, interpolando o passaro\n"
+            "                         entre passos da fisica (padrao: %d)\n"
+            "  --unicode              desenha o passaro com blocos Unicode, com meia linha\n"
+            "                         de resolucao vertical\n"
+            "  --color                canos verdes, passaro amarelo e bordas com linhas\n"
+            "                         Unicode (inclui --unicode)\n"
+            "  --birds N              N passaros no mesmo campo: os jogadores de --players e\n"
+            "                         robos com a politica do vao; com --headless, so robos,\n"
+            "                         medindo o custo por quadro\n"
+            "  --players P            jogadores locais do --birds (1 a %d, padrao 1), com as\n"
+            "                         teclas ESPACO, W, P e M\n"
+            "  --serve SOCKET         transmite a partida para espectadores no socket Unix SOCKET\n"
+            "  --watch SOCKET         assiste a uma partida transmitida com --serve (Q sai)\n"
+            "  --scores ARQUIVO       placar persistente (padrao $XDG_STATE_HOME/flappy-terminal/\n"
+            "                         " NOME_PLACAR_PADRAO ", ou em ~/.local/state); o jogo\n"
+            "                         interativo sempre registra, --headless e --batch so com\n"
+            "                         esta opcao\n"
+            "  --show-scores          mostra recordes, sobrevivencia por nivel e sessoes do placar\n"
+            "  --state ARQUIVO        estado salvo com a tecla E (padrao " CAMINHO_ESTADO_PADRAO "); com\n"
+            "                         --batch, as partidas continuam desse estado\n",
+            programa, HORIZONTE_PILOTO_PADRAO, QUADROS_POR_SEGUNDO_PADRAO, MAX_JOGADORES);
+}
+
+// Função principal - configura o jogo e executa o loop principal
+int main(int argc, char *argv[]) {
+    long quadros_headless = 0;
+    int headless = 0;
+    uint64_t semente = (uint64_t)time(NULL);
+    const char *caminho_reproducao = NULL;
+    int quadros_por_segundo = QUADROS_POR_SEGUNDO_PADRAO;
+    int unicode = 0;
+    int cores = 0;
+    ConfigLote lote = { 0 };
+    ConfigTreino treino = { 0 };
+    const char *caminho_rede = NULL;
+    const char *caminho_transmissao = NULL;
+    const char *caminho_assistir = NULL;
+    const char *caminho_placar = NULL;
+    int mostrar_placar = 0;
+    int estado_informado = 0;
+    EstadoJogo estado_inicial;
+    long max_quadros = 0;
+    int horizonte = HORIZONTE_PILOTO_PADRAO;
+    int num_passaros = 0;
+    int num_jogadores = 1;
+    
+    lote.threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    lote.politica = POLITICA_VAO;
+    lote.probabilidade = 0.05;
+    treino.populacao = 256;
+    treino.episodios = 4;
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--headless") == 0) {
+            headless = 1;
+            quadros_headless = (i + 1 < argc && argv[i + 1][0] != '-') ? atol(argv[++i]) : 10000000;
+        } else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            lote.partidas = atol(argv[++i]);
+            // O pool de lote.c divide as partidas em intervalos de 32 bits
+            if (lote.partidas < 1 || (unsigned long)lote.partidas > UINT32_MAX) {
+                fprintf(stderr, "--batch deve estar entre 1 e %lu partidas\n", (unsigned long)UINT32_MAX);
+                return 1;
             }
-        }
-        
-        char controles4[] = "Q - Sair (apos game over)";
-        int len_cont4 = strlen(controles4);
-        int start_cont4 = (LARGURA_TELA - len_cont4) / 2;
-        
-        for (int i = 0; i < len_cont4; i++) {
-            if (start_cont4 + i < LARGURA_TELA-1) {
-                tela.buffer[9][start_cont4 + i] = controles4[i];
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            lote.threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--policy") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "gap") == 0) {
+                lote.politica = POLITICA_VAO;
+            } else if (strcmp(argv[i], "random") == 0) {
+                lote.politica = POLITICA_ALEATORIA;
+            } else {
+                mostrar_uso(argv[0]);
+                return 1;
             }
-        }
-        
-        char start[] = "Pressione ESPACO para iniciar...";
-        int len_start = strlen(start);
-        int start_start = (LARGURA_TELA - len_start) / 2;
-        
-        for (int i = 0; i < len_start; i++) {
-            if (start_start + i < LARGURA_TELA-1) {
-                tela.buffer[11][start_start + i] = start[i];
+        } else if (strcmp(argv[i], "--prob") == 0 && i + 1 < argc) {
+            lote.probabilidade = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--max-frames") == 0 && i + 1 < argc) {
+            max_quadros = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--train") == 0 && i + 1 < argc) {
+            treino.geracoes = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--population") == 0 && i + 1 < argc) {
+            treino.populacao = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--episodes") == 0 && i + 1 < argc) {
+            treino.episodios = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--autopilot") == 0) {
+            usar_piloto_busca = 1;
+            horizonte = (i + 1 < argc && argv[i + 1][0] != '-') ? atoi(argv[++i]) : HORIZONTE_PILOTO_PADRAO;
+        } else if (strcmp(argv[i], "--net") == 0 && i + 1 < argc) {
+            caminho_rede = argv[++i];
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            semente = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--difficulty") == 0 && i + 1 < argc) {
+            dificuldade = dificuldade_por_nome(argv[++i]);
+            if (dificuldade < 0) {
+                mostrar_uso(argv[0]);
+                return 1;
             }
+        } else if (strcmp(argv[i], "--width") == 0 && i + 1 < argc) {
+            largura_campo = atoi(argv[++i]);
+            tamanho_fixo = 1;
+        } else if (strcmp(argv[i], "--height") == 0 && i + 1 < argc) {
+            altura_campo = atoi(argv[++i]);
+            tamanho_fixo = 1;
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            caminho_gravacao = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            caminho_reproducao = argv[++i];
+        } else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            quadros_por_segundo = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--birds") == 0 && i + 1 < argc) {
+            num_passaros = atoi(argv[++i]);
+            modo_mundo = 1;
+        } else if (strcmp(argv[i], "--players") == 0 && i + 1 < argc) {
+            num_jogadores = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--serve") == 0 && i + 1 < argc) {
+            caminho_transmissao = argv[++i];
+        } else if (strcmp(argv[i], "--watch") == 0 && i + 1 < argc) {
+            caminho_assistir = argv[++i];
+        } else if (strcmp(argv[i], "--scores") == 0 && i + 1 < argc) {
+            caminho_placar = argv[++i];
+        } else if (strcmp(argv[i], "--state") == 0 && i + 1 < argc) {
+            caminho_estado = argv[++i];
+            estado_informado = 1;
+        } else if (strcmp(argv[i], "--show-scores") == 0) {
+            mostrar_placar = 1;
+        } else if (strcmp(argv[i], "--unicode") == 0) {
+            unicode = 1;
+        } else if (strcmp(argv[i], "--color") == 0) {
+            cores = 1;
+        } else {
+            mostrar_uso(argv[0]);
+            return 1;
         }
     }
     
-    if (game_over) {
-        char game_over_text[] = "GAME OVER!";
-        int len_go = strlen(game_over_text);
-        int start_go = (LARGURA_TELA - len_go) / 2;
-        
-        for (int i = 0; i < len_go; i++) {
-            if (start_go + i < LARGURA_TELA-1) {
-                tela.buffer[ALTURA_TELA/2][start_go + i] = game_over_text[i];
-            }
+    if (largura_campo < LARGURA_MINIMA || largura_campo > LARGURA_MAXIMA ||
+        altura_campo < ALTURA_MINIMA || altura_campo > ALTURA_MAXIMA) {
+        fprintf(stderr, "Tamanho do campo deve estar entre %dx%d e %dx%d\n",
+                LARGURA_MINIMA, ALTURA_MINIMA, LARGURA_MAXIMA, ALTURA_MAXIMA);
+        return 1;
+    }
+    if (quadros_por_segundo < 1 || quadros_por_segundo > 1000) {
+        fprintf(stderr, "--fps deve estar entre 1 e 1000\n");
+        return 1;
+    }
+    
+    if (lote.threads < 1) {
+        lote.threads = 1;
+    }
+    if (horizonte < 1 || horizonte > HORIZONTE_PILOTO_MAXIMO) {
+        fprintf(stderr, "--autopilot deve estar entre 1 e %d quadros\n", HORIZONTE_PILOTO_MAXIMO);
+        return 1;
+    }
+    
+    if (modo_mundo) {
+        if (headless) {
+            num_jogadores = 0;
         }
-        
-        char restart[] = "Pressione R para reiniciar";
-        int len_restart = strlen(restart);
-        int start_restart = (LARGURA_TELA - len_restart) / 2;
-        
-        for (int i = 0; i < len_restart; i++) {
-            if (start_restart + i < LARGURA_TELA-1) {
-                tela.buffer[ALTURA_TELA/2 + 2][start_restart + i] = restart[i];
-            }
+        if (num_passaros < 1 || num_passaros > MAX_PASSAROS_MUNDO ||
+            num_jogadores < 0 || num_jogadores > MAX_JOGADORES || num_jogadores > num_passaros) {
+            fprintf(stderr, "--birds deve estar entre 1 e %d, com --players entre 1 e %d\n",
+                    MAX_PASSAROS_MUNDO, MAX_JOGADORES);
+            return 1;
         }
-        
-        char quit[] = "Pressione Q para sair";
-        int len_quit = strlen(quit);
-        int start_quit = (LARGURA_TELA - len_quit) / 2;
-        
-        for (int i = 0; i < len_quit; i++) {
-            if (start_quit + i < LARGURA_TELA-1) {
-                tela.buffer[ALTURA_TELA/2 + 4][start_quit + i] = quit[i];
-            }
+        if (lote.partidas > 0 || treino.geracoes > 0 || caminho_rede != NULL || usar_piloto_busca ||
+            caminho_reproducao != NULL || caminho_gravacao != NULL) {
+            fprintf(stderr, "--birds nao combina com --batch, --train, --net, --autopilot, --replay ou --record\n");
+            return 1;
         }
     }
-}
-
-// Renderiza o buffer da tela no terminal
-void renderizar_tela() {
-    limpar_tela();
     
-    for (int y = 0; y < ALTURA_TELA; y++) {
-        fputs(tela.buffer[y], stdout);
-        fputs("\n", stdout);
+    if (caminho_assistir != NULL) {
+        int descritor = conectar_transmissao(caminho_assistir);
+        if (descritor < 0) {
+            fprintf(stderr, "Erro ao conectar a %s\n", caminho_assistir);
+            return 1;
+        }
+        configurar_terminal();
+        ocultar_cursor();
+        assistir_transmissao(descritor);
+        fputs("\033[m", stdout);
+        limpar_tela();
+        mostrar_cursor();
+        restaurar_terminal();
+        return 0;
     }
-    fflush(stdout);
-}
-
-// Verifica se há uma tecla disponível para leitura (não bloqueante)
-int tecla_disponivel() {
-    struct timeval tv;
-    fd_set rdfs;
     
-    tv.tv_sec = 0;
-    tv.tv_usec = 0;
+    if (mostrar_placar) {
+        if (abrir_placar(caminho_placar != NULL ? caminho_placar : caminho_placar_padrao()) != 0) {
+            return 1;
+        }
+        imprimir_placar(stdout);
+        fechar_placar();
+        return 0;
+    }
     
-    FD_ZERO(&rdfs);
-    FD_SET(STDIN_FILENO, &rdfs);
+    // O jogo interativo sempre guarda o placar; as simulações só quando
+    // pedido. Sem --scores, não conseguir abrir o padrão não impede de jogar
+    int sem_placar = 0;
+    if (caminho_placar != NULL) {
+        if (abrir_placar(caminho_placar) != 0) {
+            return 1;
+        }
+    } else if (!headless && lote.partidas == 0 && treino.geracoes == 0 &&
+               abrir_placar(caminho_placar_padrao()) != 0) {
+        fprintf(stderr, "Aviso: jogando sem placar; use --scores ARQUIVO para escolher outro\n");
+        sem_placar = 1;
+    }
     
-    select(STDIN_FILENO + 1, &rdfs, NULL, NULL, &tv);
-    return FD_ISSET(STDIN_FILENO, &rdfs);
-}
-
-// Lê uma tecla se disponível, senão retorna 0
-char ler_tecla() {
-    if (tecla_disponivel()) {
-        return getchar();
+    if (treino.geracoes > 0) {
+        Rede melhor;
+        if (treino.populacao < 1 || treino.episodios < 1) {
+            fprintf(stderr, "--population e --episodes devem ser positivos\n");
+            return 1;
+        }
+        treino.populacao = (treino.populacao + LARGURA_BLOCO_REDES - 1) / LARGURA_BLOCO_REDES * LARGURA_BLOCO_REDES;
+        treino.max_quadros = max_quadros > 0 ? max_quadros : 20000;
+        treino.threads = lote.threads;
+        treino.semente = semente;
+        treino.largura = largura_campo;
+        treino.altura = altura_campo;
+        treino.dificuldade = dificuldade;
+        treino.caminho = caminho_rede != NULL ? caminho_rede : CAMINHO_REDE_PADRAO;
+        if (executar_treino(&treino, &melhor) != 0) {
+            fprintf(stderr, "Erro no treino\n");
+            return 1;
+        }
+        printf("melhor rede salva em %s\n", treino.caminho);
+        return 0;
     }
-    return 0;
-}
-
-// Processa a entrada do usuário (teclas) baseado no estado do jogo
-void processar_input() {
-    char tecla = ler_tecla();
     
-    if (!jogo_iniciado) {
-        if (tecla == ' ') {
-            jogo_iniciado = 1;
+    if (caminho_rede != NULL) {
+        if (carregar_rede(&rede_piloto, caminho_rede) != 0) {
+            fprintf(stderr, "Erro ao ler a rede %s\n", caminho_rede);
+            return 1;
         }
-    } else if (!game_over) {
-        if (tecla == ' ') {
-            passaro.velocidade = IMPULSO;
+        piloto_rede = 1;
+        lote.politica = POLITICA_REDE;
+        lote.rede = &rede_piloto;
+    } else if (usar_piloto_busca) {
+        lote.politica = POLITICA_BUSCA;
+        lote.horizonte = horizonte;
+    }
+    
+    if (lote.partidas > 0) {
+        ResultadoLote resultado;
+        lote.max_quadros = max_quadros > 0 ? max_quadros : 100000;
+        lote.semente_base = semente;
+        lote.largura = largura_campo;
+        lote.altura = altura_campo;
+        lote.dificuldade = dificuldade;
+        if (estado_informado) {
+            if (carregar_estado_arquivo(&estado_inicial, caminho_estado) != 0) {
+                fprintf(stderr, "Erro ao ler o estado %s\n", caminho_estado);
+                return 1;
+            }
+            if (estado_inicial.game_over) {
+                fprintf(stderr, "O estado %s e de uma partida encerrada\n", caminho_estado);
+                return 1;
+            }
+            lote.estado_inicial = &estado_inicial;
+            printf("continuando do quadro %ld, pontuacao %d\n", estado_inicial.quadros, estado_inicial.pontuacao);
         }
-    } else {
-        if (tecla == 'r' || tecla == 'R') {
-            inicializar_jogo();
-            jogo_iniciado = 1;
+        if (executar_lote(&lote, &resultado) != 0) {
+            fprintf(stderr, "Erro ao iniciar a simulacao em lote\n");
+            return 1;
         }
-        if (tecla == 'q' || tecla == 'Q') {
-            exit(0);
+        imprimir_resultado_lote(&lote, &resultado);
+        fechar_placar();
+        return 0;
+    }
+    
+    if (caminho_reproducao != NULL) {
+        if (carregar_replay(&reproducao, caminho_reproducao) != 0) {
+            fprintf(stderr, "Erro ao ler a gravacao %s\n", caminho_reproducao);
+            return 1;
         }
+        if (headless) {
+            int resultado = verificar_replay(&reproducao);
+            liberar_replay(&reproducao);
+            return resultado;
+        }
+        reproduzindo = 1;
+        caminho_gravacao = NULL;
     }
-}
-
-// Função principal - configura o jogo e executa o loop principal
-int main() {
+    
+    if (usar_piloto_busca && inicializar_piloto(&piloto_busca, horizonte) != 0) {
+        fprintf(stderr, "Erro ao alocar o piloto automatico\n");
+        return 1;
+    }
+    
+    if (headless && modo_mundo) {
+        if (executar_headless_mundo(quadros_headless, semente, largura_campo, altura_campo, num_passaros) != 0) {
+            fprintf(stderr, "Erro ao alocar %d passaros\n", num_passaros);
+            return 1;
+        }
+        return 0;
+    }
+    if (headless) {
+        executar_headless(quadros_headless, semente, largura_campo, altura_campo);
+        liberar_piloto(&piloto_busca);
+        fechar_placar();
+        return 0;
+    }
+    
     configurar_terminal();
     ocultar_cursor();
+    if (iniciar_entrada() != 0) {
+        mostrar_cursor();
+        restaurar_terminal();
+        fprintf(stderr, "Erro ao iniciar a leitura do teclado\n");
+        return 1;
+    }
+    
+    if (reproduzindo) {
+        largura_campo = reproducao.largura;
+        altura_campo = reproducao.altura;
+    } else if (!tamanho_fixo) {
+        obter_tamanho_terminal(&largura_campo, &altura_campo);
+        // A gravação guarda um único tamanho de campo, então gravando o campo
+        // fica no tamanho inicial do terminal, como com --width/--height
+        if (caminho_gravacao == NULL) {
+            signal(SIGWINCH, ao_redimensionar);
+        }
+    }
+    
+    if (modo_mundo && inicializar_mundo(&mundo, num_passaros, num_jogadores, semente,
+                                        largura_campo, altura_campo, dificuldade) != 0) {
+        parar_entrada();
+        restaurar_terminal();
+        mostrar_cursor();
+        fprintf(stderr, "Erro ao alocar %d passaros\n", num_passaros);
+        return 1;
+    }
+    
+    if (!modo_mundo && inicializar_historico(&historico) != 0) {
+        parar_entrada();
+        restaurar_terminal();
+        mostrar_cursor();
+        fprintf(stderr, "Erro ao alocar o historico de estados\n");
+        return 1;
+    }
+    
+    if (inicializar_tela(&tela, largura_campo, altura_campo) != 0) {
+        parar_entrada();
+        restaurar_terminal();
+        mostrar_cursor();
+        fprintf(stderr, "Erro ao alocar a tela\n");
+        return 1;
+    }
+    tela.unicode = unicode;
+    if (cores) {
+        ativar_cores(&tela);
+    }
+    if (iniciar_escritor(&tela) != 0) {
+        liberar_tela(&tela);
+        parar_entrada();
+        restaurar_terminal();
+        mostrar_cursor();
+        fprintf(stderr, "Erro ao iniciar a escrita da tela\n");
+        return 1;
+    }
+    if (caminho_transmissao != NULL && iniciar_transmissao(caminho_transmissao) != 0) {
+        parar_escritor();
+        liberar_tela(&tela);
+        parar_entrada();
+        restaurar_terminal();
+        mostrar_cursor();
+        fprintf(stderr, "Erro ao abrir a transmissao em %s\n", caminho_transmissao);
+        return 1;
+    }
+    semear_aleatorio(&aleatorio_partidas, semente);
+    nova_partida(&jogo);
+    jogo_iniciado = reproduzindo;
     
-    inicializar_tela();
-    inicializar_jogo();
+    // Física em passo fixo (a duração do passo acelera com o nível) com acumulador
+    // de tempo real; o quadro só é desenhado depois dos passos pendentes, então
+    // um terminal lento faz pular quadros em vez de desacelerar o jogo. Os quadros
+    // têm cadência própria e mostram o pássaro interpolado entre os dois últimos
+    // passos, na fração do passo que o acumulador já percorreu. Os quadros
+    // compostos vão para a thread de escrita, que descarta os intermediários
+    // se o terminal não acompanhar, então a escrita nunca atrasa a física
+    long long anterior = agora_ns();
+    long long acumulador = 0;
+    long long passo = delay_atual(&jogo) * 1000LL;
+    long long intervalo_quadro = 1000000000LL / quadros_por_segundo;
+    long long proximo_quadro = anterior;
+    uint64_t quadro_ocioso = 0;
     
-    while (1) {
-        processar_input();
+    while (!sair) {
+        long long agora = agora_ns();
+        acumulador += agora - anterior;
+        anterior = agora;
         
-        if (jogo_iniciado && !game_over) {
-            atualizar_passaro();
-            atualizar_obstaculos();
-            atualizar_desenho_passaro();
+        if (tamanho_mudou && aplicar_novo_tamanho(&jogo) != 0) {
+            break;
         }
         
-        limpar_buffer();
-        desenhar_borda();
+        // A física está simulada até (anterior - acumulador); o próximo passo
+        // cobre o intervalo seguinte de duração `passo`
+        processar_entrada(&jogo, anterior - acumulador + passo, agora);
+        long long fim_entrada = agora_ns();
+        registrar_fase(FASE_ENTRADA, fim_entrada - agora);
         
-        if (jogo_iniciado) {
-            desenhar_obstaculos();
-            desenhar_passaro();
+        int passos = 0;
+        while (acumulador >= passo && passos < PASSOS_MAXIMOS_POR_QUADRO) {
+            // Cada tecla é aplicada no início do passo cujo intervalo a contém
+            processar_entrada(&jogo, anterior - acumulador + passo, agora);
+            if (jogo_iniciado && !partida_encerrada(&jogo)) {
+                if (modo_mundo) {
+                    avancar_rodada();
+                } else {
+                    avancar_partida(&jogo);
+                }
+            }
+            acumulador -= passo;
+            passo = delay_atual(&jogo) * 1000LL;
+            passos++;
         }
         
-        desenhar_interface();
-        renderizar_tela();
+        if (passos > 1) {
+            registrar_quadros_descartados(passos - 1);
+        }
+        if (acumulador >= passo) {
+            // Atraso grande demais para recuperar: descarta em vez de acelerar depois
+            acumulador %= passo;
+        }
         
-        usleep(fps_delay_atual);
+        long long inicio_composicao = agora_ns();
+        if (passos > 0) {
+            registrar_fase(FASE_FISICA, inicio_composicao - fim_entrada);
+        }
+        
+        if (agora >= proximo_quadro) {
+            proximo_quadro += intervalo_quadro;
+            if (proximo_quadro <= agora) {
+                proximo_quadro = agora + intervalo_quadro;
+            }
+            
+            limpar_buffer(&tela);
+            desenhar_borda(&tela);
+            
+            int32_t fracao = (int32_t)(acumulador * UM_FIXO / passo);
+            if (jogo_iniciado && modo_mundo) {
+                desenhar_obstaculos(&tela, &mundo.obstaculos);
+                desenhar_passaros(&tela, &mundo, fracao);
+            } else if (jogo_iniciado) {
+                desenhar_obstaculos(&tela, &jogo.obstaculos);
+                desenhar_passaro(&tela, &jogo, fracao);
+            }
+            
+            if (modo_mundo) {
+                desenhar_interface_mundo(&tela, &mundo, jogo_iniciado);
+            } else {
+                desenhar_interface(&tela, &jogo, jogo_iniciado);
+            }
+            if (mostrar_hud) {
+                desenhar_hud(&tela);
+            }
+            
+            uint64_t sequencia = publicar_quadro(&tela);
+            registrar_fase(FASE_COMPOSICAO, agora_ns() - inicio_composicao);
+            
+            // Menu ou game over já na tela sem nenhuma mudança: nada vai mudar
+            // até uma tecla ou redimensionamento, então o loop dorme em vez de
+            // recompor a mesma tela a cada quadro. O quadro ocioso anterior é
+            // igual ao atual, e basta que a escrita o tenha enviado sem mudanças
+            int ocioso = (!jogo_iniciado || partida_encerrada(&jogo)) && !mostrar_hud;
+            if (ocioso && !sair && quadro_ocioso != 0 && quadro_sem_mudancas(quadro_ocioso)) {
+                esperar_entrada();
+                anterior = agora_ns();
+                acumulador = 0;
+                proximo_quadro = anterior;
+                continue;
+            }
+            quadro_ocioso = ocioso ? sequencia : 0;
+        }
+        
+        long long inicio_espera = agora_ns();
+        long long prazo = anterior + passo - acumulador;
+        dormir_ate(prazo < proximo_quadro ? prazo : proximo_quadro);
+        registrar_fase(FASE_ESPERA, agora_ns() - inicio_espera);
     }
     
-    liberar_tela();
+    // Escreve o último quadro, volta à cor padrão e leva o cursor para baixo
+    // do campo antes de devolver o terminal
+    parar_escritor();
+    int espectadores = num_espectadores();
+    parar_transmissao();
+    char fim_campo[32];
+    size_t n = restaurar_atributo(&tela, fim_campo);
+    n += escrever_movimento_cursor(fim_campo + n, tela.altura, 1);
+    fim_campo[n++] = '\n';
+    escrever_saida(tela.descritor, fim_campo, n);
+    
+    parar_entrada();
+    liberar_tela(&tela);
+    liberar_piloto(&piloto_busca);
+    if (modo_mundo) {
+        liberar_mundo(&mundo);
+    }
+    liberar_historico(&historico);
     mostrar_cursor();
     restaurar_terminal();
     
+    if (caminho_gravacao != NULL || reproduzindo) {
+        liberar_replay(reproduzindo ? &reproducao : &gravacao);
+    }
+    imprimir_resumo_metricas(stdout);
+    if (caminho_transmissao != NULL) {
+        printf("espectadores ao sair: %d | quadros pulados por espectadores lentos: %llu\n",
+               espectadores, (unsigned long long)total_quadros_pulados_espectadores());
+    }
+    if (estado_salvo) {
+        printf("estado salvo em %s (continue com --batch N --state %s)\n", caminho_estado, caminho_estado);
+    }
+    registrar_sessao_placar();
+    int recorde = maior_pontuacao_placar(piloto_rede || usar_piloto_busca ? ORIGEM_PILOTO : ORIGEM_JOGADOR);
+    if (!modo_mundo && !reproduzindo && recorde >= 0) {
+        printf("recorde: %d pontos (--show-scores mostra o placar)\n", recorde);
+    }
+    if (sem_placar) {
+        printf("placar desativado: nao foi possivel abrir %s\n", caminho_placar_padrao());
+    }
+    fechar_placar();
+    
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,159 @@
+#include <string.h>
+#include "gerador.h"
+#include "jogo.h"
+#include "sprite.h"
+
+_Static_assert((CAPACIDADE_GERADOR & (CAPACIDADE_GERADOR - 1)) == 0,
+               "capacidade do gerador precisa ser potência de 2");
+_Static_assert(ESPACAMENTO_MINIMO >= LARGURA_OBSTACULO + LARGURA_SPRITE + 2,
+               "espaçamento mínimo não deixa o pássaro passar entre dois canos");
+
+// O clássico é o jogo original, um vão de 8 linhas a cada 32 colunas; os
+// demais mudam vão, espaçamento e variação ao longo da partida
+const ConfigDificuldade DIFICULDADES[NUM_DIFICULDADES] = {
+    [DIFICULDADE_CLASSICA] = { "classic", { VAO_OBSTACULOS, VAO_OBSTACULOS, 0 },
+                               { ESPACAMENTO_OBSTACULOS, ESPACAMENTO_OBSTACULOS, 0 }, { 0, 0, 0 } },
+    [DIFICULDADE_FACIL] = { "easy", { 12, 9, 40 }, { 40, 34, 40 }, { 3, 6, 40 } },
+    [DIFICULDADE_DIFICIL] = { "hard", { 8, 6, 30 }, { 28, 20, 30 }, { 0, 0, 0 } },
+    [DIFICULDADE_PROGRESSIVA] = { "ramp", { 11, 5, 120 }, { 40, 16, 120 }, { 3, 12, 120 } },
+};
+
+// Índice da dificuldade com o nome dado, ou -1
+int dificuldade_por_nome(const char *nome) {
+    for (int d = 0; d < NUM_DIFICULDADES; d++) {
+        if (strcmp(DIFICULDADES[d].nome, nome) == 0) {
+            return d;
+        }
+    }
+    return -1;
+}
+
+static int limitar(int valor, int minimo, int maximo) {
+    return valor < minimo ? minimo : valor > maximo ? maximo : valor;
+}
+
+// Valor da curva no k-ésimo obstáculo da partida
+static int valor_curva(const CurvaDificuldade *curva, uint32_t k) {
+    if (k >= (uint32_t)curva->obstaculos) {
+        return curva->final;
+    }
+    return curva->inicial + (curva->final - curva->inicial) * (int)k / curva->obstaculos;
+}
+
+// Linhas que o pássaro sobe com certeza em `passos` passos de física: pulando
+// em todos, cada passo sobe exatamente -(IMPULSO + GRAVIDADE). A linha a
+// menos cobre o arredondamento da posição para a linha da tela
+static int subida_garantida(int passos) {
+    int64_t fixo = -(int64_t)passos * (IMPULSO_FIXO + GRAVIDADE_FIXO);
+    return (int)(fixo / UM_FIXO) - 1;
+}
+
+// Linhas que o pássaro desce com certeza em `passos` passos, no pior caso de
+// ter acabado de pular: a queda é a soma da velocidade a cada passo
+static int descida_garantida(int passos) {
+    int64_t fixo = (int64_t)passos * IMPULSO_FIXO + (int64_t)GRAVIDADE_FIXO * passos * (passos + 1) / 2;
+    return fixo > UM_FIXO ? (int)(fixo / UM_FIXO) - 1 : 0;
+}
+
+// Linhas que o pássaro sobe depois de um pulo antes de voltar a cair: quem
+// se mantém dentro de um vão oscila pelo menos isso
+static int oscilacao_pulo(void) {
+    int32_t velocidade = IMPULSO_FIXO;
+    int64_t y = 0, mais_alto = 0;
+    
+    while (velocidade < 0) {
+        velocidade += GRAVIDADE_FIXO;
+        y += velocidade;
+        mais_alto = y < mais_alto ? y : mais_alto;
+    }
+    return (int)((-mais_alto + UM_FIXO - 1) / UM_FIXO);
+}
+
+// Começa a sequência de obstáculos de uma partida; a fila é gerada no
+// primeiro proximo_gerado(), já com a altura do campo
+void iniciar_gerador(Gerador *gerador, uint64_t semente, int dificuldade) {
+    semear_aleatorio(&gerador->aleatorio, semente);
+    gerador->dificuldade = dificuldade;
+    gerador->inicio = 0;
+    gerador->fim = 0;
+    gerador->ultimo_superior = gerador->usado_superior = 0;
+    gerador->ultimo_vao = gerador->usado_vao = 0;
+    gerador->altura = 0;
+}
+
+// Troca o sorteio dos próximos obstáculos, mantendo os que já estão no campo
+void ressemear_gerador(Gerador *gerador, uint64_t semente) {
+    semear_aleatorio(&gerador->aleatorio, semente);
+    descartar_gerados(gerador, gerador->altura);
+}
+
+// Esquece os obstáculos da fila, gerados para outra altura de campo; os
+// próximos continuam do último que entrou no campo
+void descartar_gerados(Gerador *gerador, int altura) {
+    gerador->fim = gerador->inicio;
+    gerador->ultimo_superior = gerador->usado_superior;
+    gerador->ultimo_vao = gerador->usado_vao;
+    gerador->altura = altura;
+}
+
+// Refaz a fila a partir de um obstáculo que está no campo (vão 0 = nenhum),
+// quando o campo muda de tamanho
+void continuar_gerador(Gerador *gerador, int superior, int vao, int altura) {
+    gerador->usado_superior = superior;
+    gerador->usado_vao = vao;
+    descartar_gerados(gerador, altura);
+}
+
+// Completa a fila de uma vez. Vão e espaçamento vêm das curvas da
+// dificuldade, e o vão sempre cabe o sprite do nível em que o pássaro vai
+// passar por ele mais a oscilação de um pulo. O topo de cada vão é sorteado
+// entre as alturas que o pássaro alcança a partir do vão anterior com a
+// física real, durante os passos em que nenhum dos dois canos está sob o
+// sprite: subindo do alto do vão anterior ou descendo do fundo dele até
+// ficar inteiro no novo vão. No clássico em campos de até 35 linhas o
+// intervalo é o campo todo e o sorteio é o mesmo do jogo original
+void gerar_lote(Gerador *gerador) {
+    const ConfigDificuldade *config = &DIFICULDADES[gerador->dificuldade];
+    int altura = gerador->altura;
+    int oscilacao = oscilacao_pulo();
+    
+    while (gerador->fim - gerador->inicio < CAPACIDADE_GERADOR) {
+        uint32_t k = gerador->fim;
+        const Sprite *sprite = sprite_passaro((int)(k / PONTUACAO_PARA_PROXIMO_NIVEL));
+        int altura_sprite = sprite->base - sprite->topo + 1;
+        int largura_sprite = sprite->direita - sprite->esquerda + 1;
+        
+        int vao = limitar(valor_curva(&config->vao, k), altura_sprite + oscilacao + 1, altura - 3);
+        int espacamento = limitar(valor_curva(&config->espacamento, k), ESPACAMENTO_MINIMO, UINT8_MAX);
+        int minimo = 1;
+        int maximo = altura - vao - 2;
+        
+        if (gerador->ultimo_vao > 0) {
+            int anterior = gerador->ultimo_superior;
+            int passos = 2 * (espacamento - LARGURA_OBSTACULO - largura_sprite) - 1;
+            int variacao = valor_curva(&config->variacao, k);
+            int mais_alto = anterior - subida_garantida(passos) + altura_sprite + oscilacao - vao;
+            int mais_baixo = anterior + gerador->ultimo_vao - altura_sprite - oscilacao + descida_garantida(passos);
+            
+            if (variacao > 0) {
+                mais_alto = mais_alto > anterior - variacao ? mais_alto : anterior - variacao;
+                mais_baixo = mais_baixo < anterior + variacao ? mais_baixo : anterior + variacao;
+            }
+            minimo = mais_alto > minimo ? mais_alto : minimo;
+            maximo = mais_baixo < maximo ? mais_baixo : maximo;
+            if (minimo > maximo) {
+                // Só depois de o campo encolher: fica o mais perto possível do anterior
+                minimo = maximo = limitar(anterior, 1, altura - vao - 2);
+            }
+        }
+        
+        ObstaculoGerado *gerado = &gerador->fila[k % CAPACIDADE_GERADOR];
+        gerado->altura_superior = (uint16_t)(minimo + (int)aleatorio_intervalo(&gerador->aleatorio,
+                                                                              (uint32_t)(maximo - minimo + 1)));
+        gerado->vao = (uint8_t)vao;
+        gerado->espacamento = (uint8_t)espacamento;
+        gerador->ultimo_superior = gerado->altura_superior;
+        gerador->ultimo_vao = vao;
+        gerador->fim++;
+    }
+}
@@ -0,0 +1,83 @@
+#ifndef GERADOR_H
+#define GERADOR_H
+
+#include <stdint.h>
+#include "aleatorio.h"
+
+// Obstáculos gerados à frente de uma vez; potência de 2 para o índice do anel
+#define CAPACIDADE_GERADOR 32
+
+typedef enum {
+    DIFICULDADE_CLASSICA,
+    DIFICULDADE_FACIL,
+    DIFICULDADE_DIFICIL,
+    DIFICULDADE_PROGRESSIVA,
+    NUM_DIFICULDADES
+} Dificuldade;
+
+// Valor que vai de `inicial` a `final` em linha reta ao longo dos primeiros
+// `obstaculos` obstáculos da partida e depois fica em `final`
+typedef struct {
+    int16_t inicial, final;
+    int16_t obstaculos;
+} CurvaDificuldade;
+
+typedef struct {
+    const char *nome;
+    CurvaDificuldade vao;          // linhas livres entre os dois canos
+    CurvaDificuldade espacamento;  // colunas entre um obstáculo e o próximo
+    CurvaDificuldade variacao;     // maior mudança do topo do vão entre vizinhos (0 = livre)
+} ConfigDificuldade;
+
+typedef struct {
+    uint16_t altura_superior;
+    uint8_t vao;
+    uint8_t espacamento;  // distância até o obstáculo anterior
+} ObstaculoGerado;
+
+// Fila de obstáculos já sorteados, sem ponteiros para caber no Jogo e ser
+// copiada com ele. `inicio` e `fim` só crescem: `fim` é quantos obstáculos
+// a partida já gerou (a posição nas curvas) e fila[inicio..fim), módulo a
+// capacidade, são os que ainda não entraram no campo. O último gerado
+// limita o próximo; o último usado permite descartar a fila quando a altura
+// do campo muda
+typedef struct {
+    ObstaculoGerado fila[CAPACIDADE_GERADOR];
+    uint32_t inicio, fim;
+    int32_t ultimo_superior, ultimo_vao;
+    int32_t usado_superior, usado_vao;
+    int altura;
+    int dificuldade;
+    Aleatorio aleatorio;
+} Gerador;
+
+extern const ConfigDificuldade DIFICULDADES[NUM_DIFICULDADES];
+
+int dificuldade_por_nome(const char *nome);
+void iniciar_gerador(Gerador *gerador, uint64_t semente, int dificuldade);
+void ressemear_gerador(Gerador *gerador, uint64_t semente);
+void descartar_gerados(Gerador *gerador, int altura);
+void continuar_gerador(Gerador *gerador, int superior, int vao, int altura);
+void gerar_lote(Gerador *gerador);
+
+// Próximo obstáculo para um campo de `altura` linhas, sem tirá-lo da fila;
+// com a fila vazia, gera um lote inteiro
+static inline const ObstaculoGerado *proximo_gerado(Gerador *gerador, int altura) {
+    if (gerador->altura != altura) {
+        descartar_gerados(gerador, altura);
+    }
+    if (gerador->inicio == gerador->fim) {
+        gerar_lote(gerador);
+    }
+    return &gerador->fila[gerador->inicio % CAPACIDADE_GERADOR];
+}
+
+// Tira da fila o obstáculo devolvido por proximo_gerado()
+static inline void consumir_gerado(Gerador *gerador) {
+    const ObstaculoGerado *usado = &gerador->fila[gerador->inicio % CAPACIDADE_GERADOR];
+    gerador->usado_superior = usado->altura_superior;
+    gerador->usado_vao = usado->vao;
+    gerador->inicio++;
+}
+
+#endif
@@ -0,0 +1,291 @@
+#include <stdlib.h>
+#include "jogo.h"
+#include "sprite.h"
+
+// Inicializa o pássaro no primeiro nível de evolução (sprite com um único '#')
+void inicializar_desenho_passaro(Jogo *jogo) {
+    jogo->passaro.nivel_evolucao = 0;
+}
+
+// Delay do FPS para uma pontuação: o jogo acelera depois da evolução completa
+int fps_delay_para_pontuacao(int pontuacao) {
+    int nivel_atual = pontuacao / PONTUACAO_PARA_PROXIMO_NIVEL;
+    
+    if (nivel_atual >= 12) {
+        int pontos_apos_completo = pontuacao - 12;
+        int decrementos = pontos_apos_completo / 2;
+        int fps_delay = FPS_DELAY_BASE - (decrementos * 1000);
+        
+        return fps_delay < FPS_DELAY_MINIMO ? FPS_DELAY_MINIMO : fps_delay;
+    }
+    return FPS_DELAY_BASE;
+}
+
+// Calcula o delay do FPS baseado na evolução do pássaro para acelerar o jogo
+void calcular_fps_delay(Jogo *jogo) {
+    jogo->fps_delay_atual = fps_delay_para_pontuacao(jogo->pontuacao);
+}
+
+// Atualiza o nível de evolução pela pontuação; o desenho vem da tabela de sprites
+void atualizar_desenho_passaro(Jogo *jogo) {
+    jogo->passaro.nivel_evolucao = jogo->pontuacao / PONTUACAO_PARA_PROXIMO_NIVEL;
+}
+
+#define CAPACIDADE_PARA_LARGURA(largura) (((largura) + 10 + LARGURA_OBSTACULO) / ESPACAMENTO_MINIMO + 2)
+
+// O Jogo é copiado inteiro (histórico, piloto, forks), então em vez de
+// crescer o pool é a largura do campo que fica limitada a ele
+_Static_assert(CAPACIDADE_PARA_LARGURA(LARGURA_MAXIMA) <= MAX_OBSTACULOS,
+               "MAX_OBSTACULOS não cobre LARGURA_MAXIMA com o menor espaçamento");
+
+// Calcula quantos obstáculos cabem ao mesmo tempo na largura do campo com o
+// menor espaçamento que o gerador produz
+int capacidade_para_largura(int largura) {
+    return CAPACIDADE_PARA_LARGURA(largura);
+}
+
+// Coloca no campo, na coluna x, o próximo obstáculo do gerador
+static void criar_obstaculo(Obstaculos *obstaculos, const ObstaculoGerado *gerado, int x, int altura) {
+    int k = obstaculos->num;
+    
+    obstaculos->x[k] = x;
+    obstaculos->altura_superior[k] = gerado->altura_superior;
+    obstaculos->altura_inferior[k] = altura - gerado->altura_superior - gerado->vao;
+    obstaculos->passou &= ~(1ULL << k);
+    obstaculos->num++;
+}
+
+// Remove os obstáculos que saíram da tela e cria novos à direita até
+// preencher a largura visível. Como x é crescente, os que saíram formam um
+// prefixo e a contagem da máscara é o tamanho dele. Os novos já estão
+// prontos na fila do gerador, então por quadro o custo é olhar o primeiro
+void repor_obstaculos(Obstaculos *obstaculos, Gerador *gerador, int capacidade, int largura, int altura) {
+    uint64_t fora = mascara_menores(obstaculos->x, obstaculos->num, -LARGURA_OBSTACULO);
+    if (fora != 0) {
+        remover_primeiros(obstaculos, __builtin_popcountll(fora));
+    }
+    
+    while (obstaculos->num < capacidade) {
+        const ObstaculoGerado *gerado = proximo_gerado(gerador, altura);
+        int proximo_x = largura;
+        if (obstaculos->num > 0) {
+            proximo_x = obstaculos->x[obstaculos->num - 1] + gerado->espacamento;
+            if (proximo_x > largura + 10) {
+                break;
+            }
+        }
+        criar_obstaculo(obstaculos, gerado, proximo_x, altura);
+        consumir_gerado(gerador);
+    }
+}
+
+// Depois de uma mudança no tamanho do campo, os próximos obstáculos seguem
+// do último que ficou nele, com o vão que ele tem agora
+void seguir_ultimo_obstaculo(const Obstaculos *obstaculos, Gerador *gerador, int altura) {
+    int k = obstaculos->num - 1;
+    if (k < 0) {
+        continuar_gerador(gerador, 0, 0, altura);
+        return;
+    }
+    continuar_gerador(gerador, obstaculos->altura_superior[k],
+                      altura - obstaculos->altura_superior[k] - obstaculos->altura_inferior[k], altura);
+}
+
+// Mantém o vão de cada obstáculo quando o chão se move `diferenca` linhas
+void acompanhar_chao(Obstaculos *obstaculos, int diferenca) {
+    for (int k = 0; k < obstaculos->num; k++) {
+        int32_t *inferior = &obstaculos->altura_inferior[k];
+        *inferior += diferenca;
+        if (*inferior < 1) {
+            *inferior = 1;
+        }
+    }
+}
+
+// Inicializa todas as variáveis do jogo para um novo jogo; a semente e a
+// dificuldade definem a sequência de obstáculos, então partidas com a mesma
+// semente, dificuldade e tamanho de campo são idênticas
+void inicializar_jogo(Jogo *jogo, uint64_t semente, int largura, int altura, int dificuldade) {
+    jogo->semente = semente;
+    iniciar_gerador(&jogo->gerador, semente, dificuldade);
+    jogo->largura = largura;
+    jogo->altura = altura;
+    jogo->passaro.x = 10;
+    jogo->passaro.y = altura / 2 * UM_FIXO;
+    jogo->passaro.y_anterior = jogo->passaro.y;
+    jogo->passaro.velocidade = 0;
+    inicializar_desenho_passaro(jogo);
+    
+    jogo->obstaculos.num = 0;
+    jogo->obstaculos.passou = 0;
+    jogo->capacidade_obstaculos = capacidade_para_largura(largura);
+    repor_obstaculos(&jogo->obstaculos, &jogo->gerador, jogo->capacidade_obstaculos, largura, altura);
+    
+    jogo->pontuacao = 0;
+    jogo->game_over = 0;
+    jogo->causa_fim = FIM_NENHUM;
+    jogo->contador_obstaculos = 0;
+    jogo->quadros = 0;
+    jogo->velocidade_jogo_atual = VELOCIDADE_JOGO_BASE;
+    jogo->fps_delay_atual = FPS_DELAY_BASE;
+}
+
+// Ajusta o campo a um novo tamanho sem reiniciar a partida: os obstáculos
+// mantêm o vão e acompanham o chão, e o pássaro é trazido para dentro
+void redimensionar_jogo(Jogo *jogo, int largura, int altura) {
+    acompanhar_chao(&jogo->obstaculos, altura - jogo->altura);
+    if (LINHA_PASSARO(jogo) > altura - 3) {
+        jogo->passaro.y = (altura - 3) * UM_FIXO;
+        jogo->passaro.y_anterior = jogo->passaro.y;
+    }
+    
+    jogo->largura = largura;
+    jogo->altura = altura;
+    jogo->capacidade_obstaculos = capacidade_para_largura(largura);
+    if (jogo->obstaculos.num > jogo->capacidade_obstaculos) {
+        jogo->obstaculos.num = jogo->capacidade_obstaculos;
+    }
+    seguir_ultimo_obstaculo(&jogo->obstaculos, &jogo->gerador, altura);
+    repor_obstaculos(&jogo->obstaculos, &jogo->gerador, jogo->capacidade_obstaculos, largura, altura);
+}
+
+// Encerra a partida registrando a primeira causa de fim
+void encerrar_jogo(Jogo *jogo, CausaFim causa) {
+    if (!jogo->game_over) {
+        jogo->game_over = 1;
+        jogo->causa_fim = causa;
+        // Parado, o pássaro não tem mais o que interpolar
+        jogo->passaro.y_anterior = jogo->passaro.y;
+    }
+}
+
+// Aplica a física do pássaro (gravidade e movimento) e verifica colisões com bordas
+void atualizar_passaro(Jogo *jogo) {
+    jogo->passaro.y_anterior = jogo->passaro.y;
+    jogo->passaro.velocidade += GRAVIDADE_FIXO;
+    jogo->passaro.y += jogo->passaro.velocidade;
+    
+#if !MODO_INVENCIVEL
+    const Sprite *sprite = sprite_passaro(jogo->passaro.nivel_evolucao);
+    int passaro_top = LINHA_PASSARO(jogo) + sprite->topo;
+    int passaro_bottom = LINHA_PASSARO(jogo) + sprite->base;
+    
+    if (passaro_top <= 0) {
+        encerrar_jogo(jogo, FIM_TETO);
+    } else if (passaro_bottom >= jogo->altura-1) {
+        encerrar_jogo(jogo, FIM_CHAO);
+    }
+#endif
+}
+
+// Cada cano, deslocado até a janela de colunas do sprite, precisa caber em uma faixa
+_Static_assert(LARGURA_SPRITE + LARGURA_OBSTACULO <= BITS_LINHA_SPRITE,
+               "cano deslocado não cabe na faixa de uma linha do sprite");
+
+// Faixas da máscara empacotada do sprite (com a linha 0 na linha de tela y0)
+// cujas linhas de tela estão em [inicio, fim]
+static uint64_t faixas_linhas(int y0, int inicio, int fim) {
+    int primeira = inicio - y0 > 0 ? inicio - y0 : 0;
+    int ultima = fim - y0 < ALTURA_SPRITE - 1 ? fim - y0 : ALTURA_SPRITE - 1;
+    if (primeira > ultima) {
+        return 0;
+    }
+    
+    uint64_t ate_ultima = (ultima + 1) * BITS_LINHA_SPRITE >= 64
+        ? ~0ULL : (1ULL << (ultima + 1) * BITS_LINHA_SPRITE) - 1;
+    return ate_ultima & ~((1ULL << primeira * BITS_LINHA_SPRITE) - 1);
+}
+
+// Verifica colisões do pássaro com os canos célula a célula. Os canos cujas
+// colunas tocam a janela do sprite saem de duas comparações vetoriais; para
+// cada um, as colunas viram um bitset na janela, replicado nas linhas
+// cobertas pelo cano, e a colisão é o AND com a máscara empacotada do sprite
+void verificar_colisao_obstaculos(Jogo *jogo) {
+    const Sprite *sprite = sprite_passaro(jogo->passaro.nivel_evolucao);
+    const Obstaculos *obstaculos = &jogo->obstaculos;
+    int x0 = jogo->passaro.x - ORIGEM_SPRITE_X;
+    int y0 = LINHA_PASSARO(jogo) - ORIGEM_SPRITE_Y;
+    const uint64_t cano = (1ULL << LARGURA_OBSTACULO) - 1;
+    const uint64_t replicar = ~0ULL / MASCARA_LINHA_SPRITE;
+    
+    uint64_t na_janela = mascara_menores(obstaculos->x, obstaculos->num, x0 + LARGURA_SPRITE) &
+                         ~mascara_menores(obstaculos->x, obstaculos->num, x0 - LARGURA_OBSTACULO + 1);
+    
+    for (; na_janela != 0; na_janela &= na_janela - 1) {
+        int k = __builtin_ctzll(na_janela);
+        int deslocamento = obstaculos->x[k] - x0;
+        uint64_t colunas = deslocamento >= 0 ? cano << deslocamento : cano >> -deslocamento;
+        uint64_t celulas = sprite->linhas & colunas * replicar;
+        if (celulas == 0) {
+            continue;
+        }
+        
+#if !MODO_INVENCIVEL
+        if (celulas & faixas_linhas(y0, 1, obstaculos->altura_superior[k] - 1)) {
+            encerrar_jogo(jogo, FIM_CANO_SUPERIOR);
+        }
+        if (celulas & faixas_linhas(y0, jogo->altura - obstaculos->altura_inferior[k], jogo->altura - 2)) {
+            encerrar_jogo(jogo, FIM_CANO_INFERIOR);
+        }
+#endif
+    }
+}
+
+// Move os obstáculos, calcula FPS delay, pontuação e verifica colisões. O
+// deslocamento e a travessia do pássaro são kernels vetoriais sobre x[]
+void atualizar_obstaculos(Jogo *jogo) {
+    Obstaculos *obstaculos = &jogo->obstaculos;
+    jogo->contador_obstaculos++;
+    
+    calcular_fps_delay(jogo);
+    
+    if (jogo->contador_obstaculos >= 2) {
+        jogo->contador_obstaculos = 0;
+        subtrair_todos(obstaculos->x, obstaculos->num, 1);
+    }
+    
+    uint64_t novos = mascara_menores(obstaculos->x, obstaculos->num,
+                                     jogo->passaro.x - LARGURA_OBSTACULO) & ~obstaculos->passou;
+    jogo->pontuacao += __builtin_popcountll(novos);
+    obstaculos->passou |= novos;
+    
+    verificar_colisao_obstaculos(jogo);
+    repor_obstaculos(obstaculos, &jogo->gerador, jogo->capacidade_obstaculos, jogo->largura, jogo->altura);
+}
+
+// Aplica o impulso do pulo ao pássaro
+void pular(Jogo *jogo) {
+    jogo->passaro.velocidade = IMPULSO_FIXO;
+}
+
+// Avança a simulação em um quadro: física, obstáculos, pontuação e evolução
+void avancar_jogo(Jogo *jogo) {
+    atualizar_passaro(jogo);
+    atualizar_obstaculos(jogo);
+    atualizar_desenho_passaro(jogo);
+    jogo->quadros++;
+}
+
+// Índice do próximo obstáculo, o primeiro que não ficou para trás do
+// pássaro; igual a obstaculos.num se não houver nenhum
+int proximo_obstaculo(const Jogo *jogo) {
+    const Obstaculos *obstaculos = &jogo->obstaculos;
+    return __builtin_popcountll(mascara_menores(obstaculos->x, obstaculos->num,
+                                                jogo->passaro.x - 2 - LARGURA_OBSTACULO));
+}
+
+// Política automática simples: pula quando o pássaro está abaixo do centro
+// do vão do próximo obstáculo e não está subindo
+int politica_seguir_vao(const Jogo *jogo) {
+    const Obstaculos *obstaculos = &jogo->obstaculos;
+    const Sprite *sprite = sprite_passaro(jogo->passaro.nivel_evolucao);
+    int centro_passaro = LINHA_PASSARO(jogo) + (sprite->topo + sprite->base) / 2;
+    
+    int k = proximo_obstaculo(jogo);
+    if (k == obstaculos->num) {
+        return centro_passaro > jogo->altura / 2 && jogo->passaro.velocidade >= 0;
+    }
+    
+    int centro_vao = (obstaculos->altura_superior[k] + jogo->altura - obstaculos->altura_inferior[k]) / 2;
+    return centro_passaro > centro_vao && jogo->passaro.velocidade >= 0;
+}
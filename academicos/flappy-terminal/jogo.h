@@ -0,0 +1,98 @@
+#ifndef JOGO_H
+#define JOGO_H
+
+#include <stdint.h>
+#include "gerador.h"
+#include "obstaculos.h"
+
+#define LARGURA_TELA 80
+#define ALTURA_TELA 20
+#define GRAVIDADE 0.1
+#define IMPULSO -0.6
+#define LARGURA_OBSTACULO 4
+#define VAO_OBSTACULOS 8
+#define ESPACAMENTO_OBSTACULOS 32
+#define LARGURA_MINIMA 40
+#define ALTURA_MINIMA 16
+#define LARGURA_MAXIMA 720
+#define ALTURA_MAXIMA 500
+#define VELOCIDADE_JOGO_BASE 1.0
+#define VELOCIDADE_JOGO_MAXIMA 2.0
+#define FPS_DELAY_BASE 33333
+#define FPS_DELAY_MINIMO 16666
+#define PONTUACAO_PARA_PROXIMO_NIVEL 2
+#define MODO_INVENCIVEL 0
+
+// Menor distância entre obstáculos: o cano, o sprite mais largo e duas colunas livres
+#define ESPACAMENTO_MINIMO 12
+
+// Física vertical do pássaro em ponto fixo Q16.16 (unidade: linhas), com
+// resultado idêntico em qualquer compilador e nível de otimização
+#define BITS_FRACAO 16
+#define UM_FIXO (1 << BITS_FRACAO)
+#define PARA_FIXO(valor) ((int32_t)((valor) * UM_FIXO))
+#define GRAVIDADE_FIXO PARA_FIXO(GRAVIDADE)
+#define IMPULSO_FIXO PARA_FIXO(IMPULSO)
+
+// Linha da tela que contém uma posição em ponto fixo (arredonda para baixo)
+static inline int linha_fixo(int32_t valor) {
+    return valor >= 0 ? valor / UM_FIXO : -((-valor + UM_FIXO - 1) / UM_FIXO);
+}
+
+// y e velocidade em Q16.16; y_anterior é a posição antes do último passo,
+// usada para interpolar o desenho entre passos da física
+typedef struct {
+    int x;
+    int32_t y, y_anterior;
+    int32_t velocidade;
+    int nivel_evolucao;
+} Passaro;
+
+#define LINHA_PASSARO(jogo) linha_fixo((jogo)->passaro.y)
+
+typedef enum {
+    FIM_NENHUM,
+    FIM_TETO,
+    FIM_CHAO,
+    FIM_CANO_SUPERIOR,
+    FIM_CANO_INFERIOR,
+    NUM_CAUSAS_FIM
+} CausaFim;
+
+// Estado completo de uma partida, sem dependência de terminal ou renderização
+typedef struct {
+    Passaro passaro;
+    Obstaculos obstaculos;
+    int capacidade_obstaculos;
+    int largura, altura;
+    int pontuacao;
+    int game_over;
+    CausaFim causa_fim;
+    int contador_obstaculos;
+    float velocidade_jogo_atual;
+    int fps_delay_atual;
+    long quadros;
+    uint64_t semente;
+    Gerador gerador;
+} Jogo;
+
+int capacidade_para_largura(int largura);
+void repor_obstaculos(Obstaculos *obstaculos, Gerador *gerador, int capacidade, int largura, int altura);
+void seguir_ultimo_obstaculo(const Obstaculos *obstaculos, Gerador *gerador, int altura);
+void acompanhar_chao(Obstaculos *obstaculos, int diferenca);
+void inicializar_desenho_passaro(Jogo *jogo);
+int fps_delay_para_pontuacao(int pontuacao);
+void calcular_fps_delay(Jogo *jogo);
+void atualizar_desenho_passaro(Jogo *jogo);
+void inicializar_jogo(Jogo *jogo, uint64_t semente, int largura, int altura, int dificuldade);
+void redimensionar_jogo(Jogo *jogo, int largura, int altura);
+void encerrar_jogo(Jogo *jogo, CausaFim causa);
+void atualizar_passaro(Jogo *jogo);
+void verificar_colisao_obstaculos(Jogo *jogo);
+void atualizar_obstaculos(Jogo *jogo);
+void pular(Jogo *jogo);
+void avancar_jogo(Jogo *jogo);
+int proximo_obstaculo(const Jogo *jogo);
+int politica_seguir_vao(const Jogo *jogo);
+
+#endif
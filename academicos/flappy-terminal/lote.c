@@ -0,0 +1,350 @@
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include "lote.h"
+#include "placar.h"
+
+// Fila de itens de um trabalhador: o intervalo [inicio, fim) fica em uma
+// única palavra atômica, então o dono retira do início e os ladrões roubam
+// metade do fim com compare-and-swap, sem locks
+typedef struct Trabalhador {
+    _Alignas(64) _Atomic uint64_t intervalo;
+    TarefaParalela tarefa;
+    void *contexto;
+    struct Trabalhador *todos;
+    int num_trabalhadores;
+    int indice;
+    pthread_t thread;
+} Trabalhador;
+
+static uint64_t empacotar_intervalo(uint32_t inicio, uint32_t fim) {
+    return ((uint64_t)inicio << 32) | fim;
+}
+
+static uint32_t inicio_intervalo(uint64_t intervalo) {
+    return (uint32_t)(intervalo >> 32);
+}
+
+static uint32_t fim_intervalo(uint64_t intervalo) {
+    return (uint32_t)intervalo;
+}
+
+// Retira o próximo item do início da própria fila; retorna 0 se vazia
+static int retirar_item(Trabalhador *t, uint32_t *item) {
+    uint64_t atual = atomic_load(&t->intervalo);
+    
+    while (inicio_intervalo(atual) < fim_intervalo(atual)) {
+        uint64_t novo = empacotar_intervalo(inicio_intervalo(atual) + 1, fim_intervalo(atual));
+        if (atomic_compare_exchange_weak(&t->intervalo, &atual, novo)) {
+            *item = inicio_intervalo(atual);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Rouba metade dos itens restantes do trabalhador mais carregado e os
+// coloca na própria fila (que está vazia); retorna 0 se não há o que roubar
+static int roubar_itens(Trabalhador *t, Trabalhador *todos, int num_trabalhadores) {
+    while (1) {
+        int vitima = -1;
+        uint32_t maior_restante = 0;
+        
+        for (int i = 0; i < num_trabalhadores; i++) {
+            uint64_t v = atomic_load(&todos[i].intervalo);
+            uint32_t restante = fim_intervalo(v) - inicio_intervalo(v);
+            if (i != t->indice && restante > maior_restante) {
+                maior_restante = restante;
+                vitima = i;
+            }
+        }
+        
+        if (vitima < 0) {
+            return 0;
+        }
+        
+        uint64_t atual = atomic_load(&todos[vitima].intervalo);
+        uint32_t inicio = inicio_intervalo(atual);
+        uint32_t fim = fim_intervalo(atual);
+        if (inicio >= fim) {
+            continue;
+        }
+        
+        uint32_t metade = (fim - inicio + 1) / 2;
+        uint64_t novo = empacotar_intervalo(inicio, fim - metade);
+        if (atomic_compare_exchange_strong(&todos[vitima].intervalo, &atual, novo)) {
+            atomic_store(&t->intervalo, empacotar_intervalo(fim - metade, fim));
+            return 1;
+        }
+    }
+}
+
+// Decide se o pássaro pula neste quadro de acordo com a política configurada
+static int decidir_pulo(const ConfigLote *config, const Jogo *jogo, Aleatorio *aleatorio_politica,
+                        Piloto *piloto) {
+    double sorteio = aleatorio_real(aleatorio_politica);
+    
+    if (config->politica == POLITICA_ALEATORIA) {
+        return sorteio < config->probabilidade;
+    }
+    
+    int decisao;
+    if (config->politica == POLITICA_REDE) {
+        decisao = decidir_rede(config->rede, jogo);
+    } else if (config->politica == POLITICA_BUSCA) {
+        decisao = decidir_piloto(piloto, jogo);
+    } else {
+        decisao = politica_seguir_vao(jogo);
+    }
+    return sorteio < config->probabilidade ? !decisao : decisao;
+}
+
+// Joga uma partida completa e acumula suas estatísticas; o piloto (só na
+// política de busca) é o do trabalhador e começa vazio a cada partida
+static void simular_partida(const ConfigLote *config, uint32_t partida, ResultadoLote *resultado,
+                            Piloto *piloto) {
+    Jogo jogo;
+    Aleatorio aleatorio_politica;
+    
+    // Sementes derivadas do índice da partida: o resultado do lote não
+    // depende da divisão do trabalho entre threads. Partindo de um estado
+    // salvo, só o sorteio do gerador de obstáculos é trocado, e cada partida
+    // segue com canos diferentes a partir dali, na dificuldade do estado
+    if (config->estado_inicial != NULL) {
+        restaurar_estado(&jogo, config->estado_inicial);
+        ressemear_gerador(&jogo.gerador, misturar_semente(config->semente_base, 2 * (uint64_t)partida));
+    } else {
+        inicializar_jogo(&jogo, misturar_semente(config->semente_base, 2 * (uint64_t)partida),
+                         config->largura, config->altura, config->dificuldade);
+    }
+    long quadro_inicial = jogo.quadros;
+    semear_aleatorio(&aleatorio_politica, misturar_semente(config->semente_base, 2 * (uint64_t)partida + 1));
+    if (piloto != NULL) {
+        reiniciar_piloto(piloto);
+    }
+    
+    while (!jogo.game_over) {
+        if (config->max_quadros > 0 && jogo.quadros - quadro_inicial >= config->max_quadros) {
+            break;
+        }
+        if (decidir_pulo(config, &jogo, &aleatorio_politica, piloto)) {
+            pular(&jogo);
+        }
+        avancar_jogo(&jogo);
+    }
+    registrar_partida_placar(ORIGEM_SIMULACAO, &jogo);
+    
+    int faixa = jogo.pontuacao < PONTUACAO_MAXIMA_HISTOGRAMA ? jogo.pontuacao : PONTUACAO_MAXIMA_HISTOGRAMA;
+    resultado->histograma_pontuacao[faixa]++;
+    if (jogo.game_over) {
+        resultado->causas[jogo.causa_fim]++;
+    } else {
+        resultado->partidas_no_limite++;
+    }
+    
+    resultado->partidas++;
+    resultado->soma_pontuacao += jogo.pontuacao;
+    if (jogo.pontuacao > resultado->maior_pontuacao) {
+        resultado->maior_pontuacao = jogo.pontuacao;
+    }
+    resultado->soma_quadros += jogo.quadros;
+    if (resultado->menor_sobrevivencia < 0 || jogo.quadros < resultado->menor_sobrevivencia) {
+        resultado->menor_sobrevivencia = jogo.quadros;
+    }
+    if (jogo.quadros > resultado->maior_sobrevivencia) {
+        resultado->maior_sobrevivencia = jogo.quadros;
+    }
+}
+
+static void zerar_resultado(ResultadoLote *resultado) {
+    memset(resultado, 0, sizeof(*resultado));
+    resultado->menor_sobrevivencia = -1;
+}
+
+static void somar_resultado(ResultadoLote *total, const ResultadoLote *parcial) {
+    total->partidas += parcial->partidas;
+    for (int i = 0; i <= PONTUACAO_MAXIMA_HISTOGRAMA; i++) {
+        total->histograma_pontuacao[i] += parcial->histograma_pontuacao[i];
+    }
+    for (int i = 0; i < NUM_CAUSAS_FIM; i++) {
+        total->causas[i] += parcial->causas[i];
+    }
+    total->partidas_no_limite += parcial->partidas_no_limite;
+    total->soma_pontuacao += parcial->soma_pontuacao;
+    if (parcial->maior_pontuacao > total->maior_pontuacao) {
+        total->maior_pontuacao = parcial->maior_pontuacao;
+    }
+    total->soma_quadros += parcial->soma_quadros;
+    if (parcial->menor_sobrevivencia >= 0 &&
+        (total->menor_sobrevivencia < 0 || parcial->menor_sobrevivencia < total->menor_sobrevivencia)) {
+        total->menor_sobrevivencia = parcial->menor_sobrevivencia;
+    }
+    if (parcial->maior_sobrevivencia > total->maior_sobrevivencia) {
+        total->maior_sobrevivencia = parcial->maior_sobrevivencia;
+    }
+}
+
+static void *executar_trabalhador(void *arg) {
+    Trabalhador *t = arg;
+    uint32_t item;
+    
+    while (1) {
+        if (retirar_item(t, &item)) {
+            t->tarefa(t->contexto, item, t->indice);
+        } else if (!roubar_itens(t, t->todos, t->num_trabalhadores)) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+// Executa tarefa(contexto, item, trabalhador) para cada item em [0, total)
+// em um pool de threads com roubo de trabalho. A thread principal é o
+// trabalhador 0; retorna 0 em sucesso
+int executar_paralelo(int threads, uint32_t total, TarefaParalela tarefa, void *contexto) {
+    int n = threads;
+    
+    Trabalhador *trabalhadores = aligned_alloc(64, sizeof(Trabalhador) * n);
+    if (trabalhadores == NULL) {
+        return -1;
+    }
+    
+    for (int i = 0; i < n; i++) {
+        uint32_t inicio = (uint32_t)((uint64_t)total * i / n);
+        uint32_t fim = (uint32_t)((uint64_t)total * (i + 1) / n);
+        atomic_init(&trabalhadores[i].intervalo, empacotar_intervalo(inicio, fim));
+        trabalhadores[i].tarefa = tarefa;
+        trabalhadores[i].contexto = contexto;
+        trabalhadores[i].todos = trabalhadores;
+        trabalhadores[i].num_trabalhadores = n;
+        trabalhadores[i].indice = i;
+    }
+    
+    int iniciados = 0;
+    for (int i = 1; i < n; i++) {
+        if (pthread_create(&trabalhadores[i].thread, NULL, executar_trabalhador, &trabalhadores[i]) != 0) {
+            break;
+        }
+        iniciados = i;
+    }
+    // A thread principal também trabalha; filas de threads que não subiram são roubadas
+    executar_trabalhador(&trabalhadores[0]);
+    for (int i = 1; i <= iniciados; i++) {
+        pthread_join(trabalhadores[i].thread, NULL);
+    }
+    
+    free(trabalhadores);
+    return 0;
+}
+
+// Contexto das tarefas do lote: um resultado parcial por trabalhador e, na
+// política de busca, um piloto (com sua tabela) por trabalhador
+typedef struct {
+    const ConfigLote *config;
+    ResultadoLote *parciais;
+    Piloto *pilotos;
+} ContextoLote;
+
+static void tarefa_partida(void *contexto, uint32_t partida, int trabalhador) {
+    ContextoLote *lote = contexto;
+    simular_partida(lote->config, partida, &lote->parciais[trabalhador],
+                    lote->pilotos != NULL ? &lote->pilotos[trabalhador] : NULL);
+}
+
+static void liberar_pilotos(Piloto *pilotos, int quantidade) {
+    for (int i = 0; i < quantidade; i++) {
+        liberar_piloto(&pilotos[i]);
+    }
+    free(pilotos);
+}
+
+// Distribui as partidas entre o pool de threads e agrega as estatísticas;
+// retorna 0 em sucesso
+int executar_lote(const ConfigLote *config, ResultadoLote *resultado) {
+    int n = config->threads;
+    ContextoLote lote = { config, malloc(sizeof(ResultadoLote) * n), NULL };
+    if (lote.parciais == NULL) {
+        return -1;
+    }
+    for (int i = 0; i < n; i++) {
+        zerar_resultado(&lote.parciais[i]);
+    }
+    
+    if (config->politica == POLITICA_BUSCA) {
+        lote.pilotos = calloc(n, sizeof(Piloto));
+        int prontos = 0;
+        while (lote.pilotos != NULL && prontos < n &&
+               inicializar_piloto(&lote.pilotos[prontos], config->horizonte) == 0) {
+            prontos++;
+        }
+        if (prontos < n) {
+            if (lote.pilotos != NULL) {
+                liberar_pilotos(lote.pilotos, prontos);
+            }
+            free(lote.parciais);
+            return -1;
+        }
+    }
+    
+    struct timespec inicio, fim;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    
+    int erro = executar_paralelo(n, (uint32_t)config->partidas, tarefa_partida, &lote);
+    if (lote.pilotos != NULL) {
+        liberar_pilotos(lote.pilotos, n);
+    }
+    if (erro != 0) {
+        free(lote.parciais);
+        return -1;
+    }
+    
+    clock_gettime(CLOCK_MONOTONIC, &fim);
+    
+    zerar_resultado(resultado);
+    for (int i = 0; i < n; i++) {
+        somar_resultado(resultado, &lote.parciais[i]);
+    }
+    resultado->segundos = (fim.tv_sec - inicio.tv_sec) + (fim.tv_nsec - inicio.tv_nsec) / 1e9;
+    
+    free(lote.parciais);
+    return 0;
+}
+
+// Imprime as estatísticas do lote: histograma de pontuação, sobrevivência e causas de fim
+void imprimir_resultado_lote(const ConfigLote *config, const ResultadoLote *resultado) {
+    static const char *nomes_causas[NUM_CAUSAS_FIM] = {
+        "nenhuma", "teto", "chao", "cano superior", "cano inferior"
+    };
+    long partidas = resultado->partidas > 0 ? resultado->partidas : 1;
+    
+    printf("partidas: %ld (%d threads)\n", resultado->partidas, config->threads);
+    printf("pontuacao media: %.2f | maior: %d\n",
+           (double)resultado->soma_pontuacao / partidas, resultado->maior_pontuacao);
+    printf("sobrevivencia (quadros): media %.1f | menor %ld | maior %ld\n",
+           (double)resultado->soma_quadros / partidas,
+           resultado->menor_sobrevivencia < 0 ? 0 : resultado->menor_sobrevivencia,
+           resultado->maior_sobrevivencia);
+    
+    printf("causas de fim:\n");
+    for (int i = FIM_TETO; i < NUM_CAUSAS_FIM; i++) {
+        printf("  %-14s %ld\n", nomes_causas[i], resultado->causas[i]);
+    }
+    printf("  %-14s %ld\n", "limite quadros", resultado->partidas_no_limite);
+    
+    printf("histograma de pontuacao:\n");
+    for (int i = 0; i <= PONTUACAO_MAXIMA_HISTOGRAMA; i++) {
+        if (resultado->histograma_pontuacao[i] > 0) {
+            printf("  %s%3d %ld\n", i == PONTUACAO_MAXIMA_HISTOGRAMA ? ">=" : "  ",
+                   i, resultado->histograma_pontuacao[i]);
+        }
+    }
+    
+    double segundos = resultado->segundos > 0 ? resultado->segundos : 1e-9;
+    printf("tempo: %.3f s (%.0f partidas/s, %.0f quadros/s)\n", resultado->segundos,
+           resultado->partidas / segundos, resultado->soma_quadros / segundos);
+}
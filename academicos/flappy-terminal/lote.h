@@ -0,0 +1,54 @@
+#ifndef LOTE_H
+#define LOTE_H
+
+#include "jogo.h"
+#include "estado.h"
+#include "rede.h"
+#include "piloto.h"
+
+#define PONTUACAO_MAXIMA_HISTOGRAMA 64
+
+typedef enum {
+    POLITICA_VAO,
+    POLITICA_ALEATORIA,
+    POLITICA_REDE,
+    POLITICA_BUSCA
+} TipoPolitica;
+
+// Parâmetros de uma simulação em lote
+typedef struct {
+    long partidas;
+    int threads;
+    uint64_t semente_base;
+    TipoPolitica politica;
+    double probabilidade;  // aleatória: chance de pular por quadro; demais: chance de errar a decisão
+    const Rede *rede;      // rede que decide os pulos na política POLITICA_REDE
+    int horizonte;         // quadros à frente explorados na política POLITICA_BUSCA
+    long max_quadros;      // encerra partidas que sobrevivem além deste limite (0 = sem limite)
+    int largura, altura;   // tamanho do campo de cada partida
+    int dificuldade;       // curvas do gerador de obstáculos
+    const EstadoJogo *estado_inicial;  // se não for NULL, as partidas continuam dele
+} ConfigLote;
+
+// Estatísticas agregadas de todas as partidas do lote
+typedef struct {
+    long partidas;
+    long histograma_pontuacao[PONTUACAO_MAXIMA_HISTOGRAMA + 1];
+    long causas[NUM_CAUSAS_FIM];
+    long partidas_no_limite;
+    long long soma_pontuacao;
+    int maior_pontuacao;
+    long long soma_quadros;
+    long menor_sobrevivencia;
+    long maior_sobrevivencia;
+    double segundos;
+} ResultadoLote;
+
+// Processa o item `indice` na thread de índice `trabalhador` (0 a threads - 1)
+typedef void (*TarefaParalela)(void *contexto, uint32_t indice, int trabalhador);
+
+int executar_paralelo(int threads, uint32_t total, TarefaParalela tarefa, void *contexto);
+int executar_lote(const ConfigLote *config, ResultadoLote *resultado);
+void imprimir_resultado_lote(const ConfigLote *config, const ResultadoLote *resultado);
+
+#endif
@@ -0,0 +1,150 @@
+#include <stdatomic.h>
+#include "metricas.h"
+
+// Histograma log-linear de durações: 8 baldes por potência de 2, de 64 ns a
+// ~68 s, com erro relativo máximo de ~6% usando o centro do balde. Os contadores são
+// atômicos com ordem relaxada, então qualquer thread registra sem locks
+#define BITS_MINIMO 6
+#define BITS_MAXIMO 36
+#define SUBBALDES 8
+#define BITS_SUBBALDE 3
+#define NUM_BALDES ((BITS_MAXIMO - BITS_MINIMO) * SUBBALDES)
+
+typedef struct {
+    _Atomic uint64_t baldes[NUM_BALDES];
+    _Atomic uint64_t contagem;
+    _Atomic uint64_t soma_ns;
+    _Atomic uint64_t maximo_ns;
+} Histograma;
+
+static Histograma histogramas[NUM_FASES];
+static _Atomic uint64_t bytes_escritos;
+static _Atomic uint64_t quadros_escritos;
+static _Atomic uint64_t quadros_descartados;
+static _Atomic uint64_t quadros_coalescidos;
+static _Atomic uint64_t bytes_ultimo;
+
+static const char *nomes_fases[NUM_FASES] = {
+    "entrada", "fisica", "composicao", "escrita", "espera", "quadro", "lat. tecla"
+};
+
+static int balde_para_ns(uint64_t ns) {
+    if (ns < (1ULL << BITS_MINIMO)) {
+        return 0;
+    }
+    int bits = 63 - __builtin_clzll(ns);
+    if (bits >= BITS_MAXIMO) {
+        return NUM_BALDES - 1;
+    }
+    int sub = (int)((ns >> (bits - BITS_SUBBALDE)) & (SUBBALDES - 1));
+    return (bits - BITS_MINIMO) * SUBBALDES + sub;
+}
+
+// Centro do balde, usado como estimativa do percentil
+static uint64_t centro_do_balde(int balde) {
+    int bits = balde / SUBBALDES + BITS_MINIMO;
+    int sub = balde % SUBBALDES;
+    return (1ULL << bits) + ((uint64_t)(2 * sub + 1) << (bits - BITS_SUBBALDE - 1));
+}
+
+// Registra a duração de uma fase do quadro
+void registrar_fase(Fase fase, long long ns) {
+    Histograma *h = &histogramas[fase];
+    uint64_t valor = ns > 0 ? (uint64_t)ns : 0;
+    
+    atomic_fetch_add_explicit(&h->baldes[balde_para_ns(valor)], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&h->contagem, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&h->soma_ns, valor, memory_order_relaxed);
+    
+    uint64_t maximo = atomic_load_explicit(&h->maximo_ns, memory_order_relaxed);
+    while (valor > maximo &&
+           !atomic_compare_exchange_weak_explicit(&h->maximo_ns, &maximo, valor,
+                                                  memory_order_relaxed, memory_order_relaxed));
+}
+
+// Registra um quadro enviado ao terminal e seu tamanho em bytes
+void registrar_quadro_escrito(size_t bytes) {
+    atomic_fetch_add_explicit(&bytes_escritos, bytes, memory_order_relaxed);
+    atomic_fetch_add_explicit(&quadros_escritos, 1, memory_order_relaxed);
+    atomic_store_explicit(&bytes_ultimo, bytes, memory_order_relaxed);
+}
+
+// Registra quadros que não foram desenhados porque o jogo estava atrasado
+void registrar_quadros_descartados(long quadros) {
+    atomic_fetch_add_explicit(&quadros_descartados, (uint64_t)quadros, memory_order_relaxed);
+}
+
+// Registra quadros compostos que a thread de escrita pulou porque um quadro
+// mais novo ficou pronto antes de ela terminar o anterior
+void registrar_quadros_coalescidos(uint64_t quadros) {
+    atomic_fetch_add_explicit(&quadros_coalescidos, quadros, memory_order_relaxed);
+}
+
+// Estima o percentil (0 a 100) de uma fase em nanossegundos; 0 se vazia
+long long percentil_fase(Fase fase, double percentil) {
+    Histograma *h = &histogramas[fase];
+    uint64_t total = atomic_load_explicit(&h->contagem, memory_order_relaxed);
+    if (total == 0) {
+        return 0;
+    }
+    
+    uint64_t maximo = atomic_load_explicit(&h->maximo_ns, memory_order_relaxed);
+    uint64_t alvo = (uint64_t)(total * percentil / 100.0);
+    uint64_t acumulado = 0;
+    for (int i = 0; i < NUM_BALDES; i++) {
+        acumulado += atomic_load_explicit(&h->baldes[i], memory_order_relaxed);
+        if (acumulado > alvo) {
+            uint64_t estimativa = centro_do_balde(i);
+            return (long long)(estimativa < maximo ? estimativa : maximo);
+        }
+    }
+    return (long long)maximo;
+}
+
+uint64_t total_bytes_escritos(void) {
+    return atomic_load_explicit(&bytes_escritos, memory_order_relaxed);
+}
+
+uint64_t total_quadros_escritos(void) {
+    return atomic_load_explicit(&quadros_escritos, memory_order_relaxed);
+}
+
+uint64_t total_quadros_descartados(void) {
+    return atomic_load_explicit(&quadros_descartados, memory_order_relaxed);
+}
+
+uint64_t total_quadros_coalescidos(void) {
+    return atomic_load_explicit(&quadros_coalescidos, memory_order_relaxed);
+}
+
+uint64_t bytes_ultimo_quadro(void) {
+    return atomic_load_explicit(&bytes_ultimo, memory_order_relaxed);
+}
+
+// Imprime o resumo de tempos por fase e o volume de saída
+void imprimir_resumo_metricas(FILE *saida) {
+    fprintf(saida, "%-11s %10s %10s %10s %10s %10s\n",
+            "fase", "amostras", "media ms", "p50 ms", "p99 ms", "max ms");
+    
+    for (int f = 0; f < NUM_FASES; f++) {
+        Histograma *h = &histogramas[f];
+        uint64_t contagem = atomic_load_explicit(&h->contagem, memory_order_relaxed);
+        uint64_t soma = atomic_load_explicit(&h->soma_ns, memory_order_relaxed);
+        uint64_t maximo = atomic_load_explicit(&h->maximo_ns, memory_order_relaxed);
+        
+        fprintf(saida, "%-11s %10llu %10.3f %10.3f %10.3f %10.3f\n", nomes_fases[f],
+                (unsigned long long)contagem,
+                contagem ? soma / 1e6 / contagem : 0.0,
+                percentil_fase((Fase)f, 50) / 1e6,
+                percentil_fase((Fase)f, 99) / 1e6,
+                maximo / 1e6);
+    }
+    
+    uint64_t quadros = total_quadros_escritos();
+    uint64_t bytes = total_bytes_escritos();
+    fprintf(saida, "quadros escritos: %llu | descartados: %llu | coalescidos: %llu\n",
+            (unsigned long long)quadros, (unsigned long long)total_quadros_descartados(),
+            (unsigned long long)total_quadros_coalescidos());
+    fprintf(saida, "bytes escritos: %llu (%.1f por quadro)\n",
+            (unsigned long long)bytes, quadros ? (double)bytes / quadros : 0.0);
+}
@@ -0,0 +1,30 @@
+#ifndef METRICAS_H
+#define METRICAS_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+typedef enum {
+    FASE_ENTRADA,
+    FASE_FISICA,
+    FASE_COMPOSICAO,
+    FASE_ESCRITA,
+    FASE_ESPERA,
+    FASE_QUADRO,
+    FASE_LATENCIA_ENTRADA,
+    NUM_FASES
+} Fase;
+
+void registrar_fase(Fase fase, long long ns);
+void registrar_quadro_escrito(size_t bytes);
+void registrar_quadros_descartados(long quadros);
+void registrar_quadros_coalescidos(uint64_t quadros);
+long long percentil_fase(Fase fase, double percentil);
+uint64_t total_bytes_escritos(void);
+uint64_t total_quadros_escritos(void);
+uint64_t total_quadros_descartados(void);
+uint64_t total_quadros_coalescidos(void);
+uint64_t bytes_ultimo_quadro(void);
+void imprimir_resumo_metricas(FILE *saida);
+
+#endif
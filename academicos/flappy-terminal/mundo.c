@@ -0,0 +1,436 @@
+#include <stdlib.h>
+#include <string.h>
+#include "mundo.h"
+#include "sprite.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define LARGURA_VETOR 8
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define LARGURA_VETOR 4
+#else
+#define LARGURA_VETOR 1
+#endif
+
+#define MASCARA_VETOR ((1u << LARGURA_VETOR) - 1)
+
+_Static_assert(64 % LARGURA_VETOR == 0, "cada palavra de vivos deve cobrir vetores inteiros");
+
+#if defined(__AVX2__)
+// Expande os bits [0, LARGURA_VETOR) em pistas de 32 bits todas ligadas ou desligadas
+static inline __m256i expandir_bits(unsigned bits) {
+    const __m256i pesos = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    return _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32((int)bits), pesos), pesos);
+}
+#elif defined(__SSE2__)
+static inline __m128i expandir_bits(unsigned bits) {
+    const __m128i pesos = _mm_setr_epi32(1, 2, 4, 8);
+    return _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32((int)bits), pesos), pesos);
+}
+#endif
+
+// Gravidade e movimento dos pássaros vivos, vetor a vetor. Palavras sem
+// nenhum vivo são puladas inteiras; nas outras, os mortos ficam parados
+static void mover_passaros(Passaros *passaros) {
+    for (int w = 0; w < passaros->palavras; w++) {
+        uint64_t vivos = passaros->vivos[w];
+        if (vivos == 0) {
+            continue;
+        }
+        int32_t *y = passaros->y + w * 64;
+        int32_t *y_anterior = passaros->y_anterior + w * 64;
+        int32_t *velocidade = passaros->velocidade + w * 64;
+        
+#if defined(__AVX2__)
+        const __m256i gravidade = _mm256_set1_epi32(GRAVIDADE_FIXO);
+        for (int i = 0; i < 64; i += LARGURA_VETOR) {
+            __m256i vivo = expandir_bits((unsigned)(vivos >> i) & MASCARA_VETOR);
+            __m256i vy = _mm256_load_si256((const __m256i *)(y + i));
+            __m256i vv = _mm256_add_epi32(_mm256_load_si256((const __m256i *)(velocidade + i)),
+                                          _mm256_and_si256(gravidade, vivo));
+            _mm256_store_si256((__m256i *)(y_anterior + i), vy);
+            _mm256_store_si256((__m256i *)(velocidade + i), vv);
+            _mm256_store_si256((__m256i *)(y + i), _mm256_add_epi32(vy, _mm256_and_si256(vv, vivo)));
+        }
+#elif defined(__SSE2__)
+        const __m128i gravidade = _mm_set1_epi32(GRAVIDADE_FIXO);
+        for (int i = 0; i < 64; i += LARGURA_VETOR) {
+            __m128i vivo = expandir_bits((unsigned)(vivos >> i) & MASCARA_VETOR);
+            __m128i vy = _mm_load_si128((const __m128i *)(y + i));
+            __m128i vv = _mm_add_epi32(_mm_load_si128((const __m128i *)(velocidade + i)),
+                                       _mm_and_si128(gravidade, vivo));
+            _mm_store_si128((__m128i *)(y_anterior + i), vy);
+            _mm_store_si128((__m128i *)(velocidade + i), vv);
+            _mm_store_si128((__m128i *)(y + i), _mm_add_epi32(vy, _mm_and_si128(vv, vivo)));
+        }
+#else
+        for (int i = 0; i < 64; i++) {
+            y_anterior[i] = y[i];
+            if (vivos >> i & 1) {
+                velocidade[i] += GRAVIDADE_FIXO;
+                y[i] += velocidade[i];
+            }
+        }
+#endif
+    }
+}
+
+// Marca como mortos os pássaros vivos cuja linha está fora de [minima,
+// maxima]. A linha é o deslocamento aritmético de y, que arredonda para
+// baixo como linha_fixo(). Retorna quantos morreram
+static int colidir_passaros(Passaros *passaros, int32_t minima, int32_t maxima) {
+    int mortos = 0;
+    
+    for (int w = 0; w < passaros->palavras; w++) {
+        uint64_t vivos = passaros->vivos[w];
+        if (vivos == 0) {
+            continue;
+        }
+        const int32_t *y = passaros->y + w * 64;
+        uint64_t fora = 0;
+        
+#if defined(__AVX2__)
+        const __m256i vminima = _mm256_set1_epi32(minima);
+        const __m256i vmaxima = _mm256_set1_epi32(maxima);
+        for (int i = 0; i < 64; i += LARGURA_VETOR) {
+            __m256i linha = _mm256_srai_epi32(_mm256_load_si256((const __m256i *)(y + i)), BITS_FRACAO);
+            __m256i saiu = _mm256_or_si256(_mm256_cmpgt_epi32(vminima, linha),
+                                           _mm256_cmpgt_epi32(linha, vmaxima));
+            fora |= (uint64_t)_mm256_movemask_ps(_mm256_castsi256_ps(saiu)) << i;
+        }
+#elif defined(__SSE2__)
+        const __m128i vminima = _mm_set1_epi32(minima);
+        const __m128i vmaxima = _mm_set1_epi32(maxima);
+        for (int i = 0; i < 64; i += LARGURA_VETOR) {
+            __m128i linha = _mm_srai_epi32(_mm_load_si128((const __m128i *)(y + i)), BITS_FRACAO);
+            __m128i saiu = _mm_or_si128(_mm_cmpgt_epi32(vminima, linha), _mm_cmpgt_epi32(linha, vmaxima));
+            fora |= (uint64_t)_mm_movemask_ps(_mm_castsi128_ps(saiu)) << i;
+        }
+#else
+        for (int i = 0; i < 64; i++) {
+            int linha = linha_fixo(y[i]);
+            fora |= (uint64_t)(linha < minima || linha > maxima) << i;
+        }
+#endif
+        
+        // Parado, o pássaro morto não tem mais o que interpolar
+        fora &= vivos;
+        passaros->vivos[w] = vivos & ~fora;
+        for (; fora != 0; fora &= fora - 1) {
+            int j = w * 64 + __builtin_ctzll(fora);
+            passaros->y_anterior[j] = passaros->y[j];
+            mortos++;
+        }
+    }
+    return mortos;
+}
+
+// Faixa [minima, maxima] de linhas em que um pássaro com este sprite, na
+// coluna do mundo, não toca teto, chão nem canos: a mesma condição de
+// atualizar_passaro() e verificar_colisao_obstaculos(). Para cada cano na
+// janela do sprite só importam a primeira e a última linha do sprite com
+// células nas colunas do cano, que precisam ficar abaixo do cano de cima e
+// acima do de baixo. O custo é por cano, não por pássaro
+static void faixa_livre(const Mundo *mundo, const Sprite *sprite, int32_t *minima, int32_t *maxima) {
+    const Obstaculos *obstaculos = &mundo->obstaculos;
+    int x0 = mundo->x - ORIGEM_SPRITE_X;
+    const uint64_t cano = (1ULL << LARGURA_OBSTACULO) - 1;
+    const uint64_t replicar = ~0ULL / MASCARA_LINHA_SPRITE;
+    
+    *minima = 1 - sprite->topo;
+    *maxima = mundo->altura - 2 - sprite->base;
+    
+    uint64_t na_janela = mascara_menores(obstaculos->x, obstaculos->num, x0 + LARGURA_SPRITE) &
+                         ~mascara_menores(obstaculos->x, obstaculos->num, x0 - LARGURA_OBSTACULO + 1);
+    
+    for (; na_janela != 0; na_janela &= na_janela - 1) {
+        int k = __builtin_ctzll(na_janela);
+        int deslocamento = obstaculos->x[k] - x0;
+        uint64_t colunas = deslocamento >= 0 ? cano << deslocamento : cano >> -deslocamento;
+        uint64_t celulas = sprite->linhas & colunas * replicar;
+        if (celulas == 0) {
+            continue;
+        }
+        
+        int primeira = __builtin_ctzll(celulas) / BITS_LINHA_SPRITE;
+        int ultima = (63 - __builtin_clzll(celulas)) / BITS_LINHA_SPRITE;
+        int32_t abaixo_superior = obstaculos->altura_superior[k] - primeira + ORIGEM_SPRITE_Y;
+        int32_t acima_inferior = mundo->altura - obstaculos->altura_inferior[k] - 1 - ultima + ORIGEM_SPRITE_Y;
+        if (abaixo_superior > *minima) {
+            *minima = abaixo_superior;
+        }
+        if (acima_inferior < *maxima) {
+            *maxima = acima_inferior;
+        }
+    }
+    
+#if MODO_INVENCIVEL
+    *minima = INT32_MIN;
+    *maxima = INT32_MAX;
+#endif
+}
+
+// Copia a pontuação e o nível comuns para os pássaros vivos; só roda quando
+// um cano é ultrapassado
+static void atribuir_pontuacao(Passaros *passaros, int32_t pontuacao, int32_t nivel) {
+    for (int w = 0; w < passaros->palavras; w++) {
+        for (uint64_t vivos = passaros->vivos[w]; vivos != 0; vivos &= vivos - 1) {
+            int j = w * 64 + __builtin_ctzll(vivos);
+            passaros->pontuacao[j] = pontuacao;
+            passaros->nivel[j] = nivel;
+        }
+    }
+}
+
+// Junta os robôs vivos logo depois dos jogadores, na mesma ordem, para que
+// os kernels percorram só palavras densas: o custo do quadro passa a seguir
+// os vivos, não o total. Os robôs não têm identidade, então os mortos são
+// simplesmente sobrescritos; os jogadores ficam nos seus índices
+static void compactar_robos(Mundo *mundo) {
+    Passaros *passaros = &mundo->passaros;
+    int destino = mundo->num_jogadores;
+    
+    for (int i = mundo->num_jogadores; i < passaros->palavras * 64; i++) {
+        if (!passaro_vivo(passaros, i)) {
+            continue;
+        }
+        passaros->y[destino] = passaros->y[i];
+        passaros->y_anterior[destino] = passaros->y_anterior[i];
+        passaros->velocidade[destino] = passaros->velocidade[i];
+        passaros->nivel[destino] = passaros->nivel[i];
+        passaros->pontuacao[destino] = passaros->pontuacao[i];
+        destino++;
+    }
+    
+    uint64_t jogadores = passaros->vivos[0] & mascara_ativos(mundo->num_jogadores);
+    for (int w = 0; w < passaros->palavras; w++) {
+        int restantes = destino - w * 64;
+        passaros->vivos[w] = restantes > 0 ? mascara_ativos(restantes) : 0;
+    }
+    passaros->vivos[0] = (passaros->vivos[0] & ~mascara_ativos(mundo->num_jogadores)) | jogadores;
+    passaros->palavras = (destino + 63) / 64;
+}
+
+// Aloca os arrays de `num_passaros` pássaros (os `num_jogadores` primeiros
+// são de jogadores) em um único bloco e começa a primeira rodada. Retorna 0
+// em sucesso
+int inicializar_mundo(Mundo *mundo, int num_passaros, int num_jogadores, uint64_t semente,
+                      int largura, int altura, int dificuldade) {
+    if (num_passaros < 1 || num_passaros > MAX_PASSAROS_MUNDO ||
+        num_jogadores < 0 || num_jogadores > MAX_JOGADORES || num_jogadores > num_passaros) {
+        return -1;
+    }
+    
+    Passaros *passaros = &mundo->passaros;
+    passaros->num = num_passaros;
+    passaros->capacidade = (num_passaros + 63) / 64 * 64;
+    size_t tamanho_array = (size_t)passaros->capacidade * sizeof(int32_t);
+    size_t tamanho = 5 * tamanho_array + (size_t)passaros->capacidade / 64 * sizeof(uint64_t);
+    
+    char *bloco = aligned_alloc(64, (tamanho + 63) / 64 * 64);
+    if (bloco == NULL) {
+        return -1;
+    }
+    passaros->y = (int32_t *)bloco;
+    passaros->y_anterior = (int32_t *)(bloco + tamanho_array);
+    passaros->velocidade = (int32_t *)(bloco + 2 * tamanho_array);
+    passaros->nivel = (int32_t *)(bloco + 3 * tamanho_array);
+    passaros->pontuacao = (int32_t *)(bloco + 4 * tamanho_array);
+    passaros->vivos = (uint64_t *)(bloco + 5 * tamanho_array);
+    
+    mundo->num_jogadores = num_jogadores;
+    mundo->bits_erro = BITS_ERRO_ROBOS;
+    mundo->largura = largura;
+    mundo->altura = altura;
+    mundo->gerador.dificuldade = dificuldade;
+    reiniciar_mundo(mundo, semente);
+    return 0;
+}
+
+// Começa uma nova rodada com todos os pássaros vivos no meio do campo; a
+// semente define os obstáculos, na dificuldade do mundo, e os erros dos robôs
+void reiniciar_mundo(Mundo *mundo, uint64_t semente) {
+    Passaros *passaros = &mundo->passaros;
+    int32_t y = mundo->altura / 2 * UM_FIXO;
+    
+    for (int i = 0; i < passaros->capacidade; i++) {
+        passaros->y[i] = i < passaros->num ? y : 0;
+        passaros->y_anterior[i] = passaros->y[i];
+    }
+    memset(passaros->velocidade, 0, (size_t)passaros->capacidade * sizeof(int32_t));
+    memset(passaros->nivel, 0, (size_t)passaros->capacidade * sizeof(int32_t));
+    memset(passaros->pontuacao, 0, (size_t)passaros->capacidade * sizeof(int32_t));
+    passaros->palavras = passaros->capacidade / 64;
+    for (int w = 0; w < passaros->palavras; w++) {
+        int restantes = passaros->num - w * 64;
+        passaros->vivos[w] = restantes > 0 ? mascara_ativos(restantes) : 0;
+    }
+    
+    mundo->semente = semente;
+    iniciar_gerador(&mundo->gerador, semente, mundo->gerador.dificuldade);
+    semear_aleatorio(&mundo->aleatorio_robos, misturar_semente(semente, 1));
+    mundo->x = 10;
+    mundo->obstaculos.num = 0;
+    mundo->obstaculos.passou = 0;
+    mundo->capacidade_obstaculos = capacidade_para_largura(mundo->largura);
+    repor_obstaculos(&mundo->obstaculos, &mundo->gerador, mundo->capacidade_obstaculos,
+                     mundo->largura, mundo->altura);
+    
+    mundo->num_vivos = passaros->num;
+    mundo->pontuacao = 0;
+    mundo->nivel = 0;
+    mundo->game_over = 0;
+    mundo->contador_obstaculos = 0;
+    mundo->fps_delay_atual = FPS_DELAY_BASE;
+    mundo->quadros = 0;
+}
+
+// Ajusta o campo a um novo tamanho como redimensionar_jogo(), trazendo para
+// dentro todos os pássaros
+void redimensionar_mundo(Mundo *mundo, int largura, int altura) {
+    Passaros *passaros = &mundo->passaros;
+    
+    acompanhar_chao(&mundo->obstaculos, altura - mundo->altura);
+    for (int i = 0; i < passaros->num; i++) {
+        if (linha_fixo(passaros->y[i]) > altura - 3) {
+            passaros->y[i] = (altura - 3) * UM_FIXO;
+            passaros->y_anterior[i] = passaros->y[i];
+        }
+    }
+    
+    mundo->largura = largura;
+    mundo->altura = altura;
+    mundo->capacidade_obstaculos = capacidade_para_largura(largura);
+    if (mundo->obstaculos.num > mundo->capacidade_obstaculos) {
+        mundo->obstaculos.num = mundo->capacidade_obstaculos;
+    }
+    seguir_ultimo_obstaculo(&mundo->obstaculos, &mundo->gerador, altura);
+    repor_obstaculos(&mundo->obstaculos, &mundo->gerador, mundo->capacidade_obstaculos, largura, altura);
+}
+
+void liberar_mundo(Mundo *mundo) {
+    free(mundo->passaros.y);
+    mundo->passaros.y = NULL;
+}
+
+// Aplica o impulso do pulo a um pássaro, se ele ainda estiver vivo
+void pular_passaro(Mundo *mundo, int indice) {
+    if (indice < mundo->passaros.num && passaro_vivo(&mundo->passaros, indice)) {
+        mundo->passaros.velocidade[indice] = IMPULSO_FIXO;
+    }
+}
+
+// Decide e aplica os pulos de todos os robôs vivos com a política de
+// politica_seguir_vao(). Os vivos têm o mesmo sprite e o mesmo próximo cano,
+// então "centro do pássaro abaixo do centro do vão" vira uma comparação da
+// linha com um limite comum. Os erros são sorteados 64 robôs por vez, com o
+// AND de BITS_ERRO_ROBOS palavras aleatórias
+void pular_robos(Mundo *mundo) {
+    Passaros *passaros = &mundo->passaros;
+    const Obstaculos *obstaculos = &mundo->obstaculos;
+    const Sprite *sprite = sprite_passaro(mundo->nivel);
+    
+    int k = __builtin_popcountll(mascara_menores(obstaculos->x, obstaculos->num,
+                                                 mundo->x - 2 - LARGURA_OBSTACULO));
+    int centro_vao = k == obstaculos->num ? mundo->altura / 2
+        : (obstaculos->altura_superior[k] + mundo->altura - obstaculos->altura_inferior[k]) / 2;
+    int32_t limite = centro_vao - (sprite->topo + sprite->base) / 2;
+    
+    for (int w = 0; w < passaros->palavras; w++) {
+        uint64_t robos = passaros->vivos[w];
+        if (w == 0) {
+            robos &= ~mascara_ativos(mundo->num_jogadores);
+        }
+        if (robos == 0) {
+            continue;
+        }
+        if (mundo->bits_erro > 0) {
+            uint64_t erro = ~0ULL;
+            for (int b = 0; b < mundo->bits_erro; b++) {
+                erro &= (uint64_t)proximo_aleatorio(&mundo->aleatorio_robos) << 32 |
+                        proximo_aleatorio(&mundo->aleatorio_robos);
+            }
+            robos &= ~erro;
+        }
+        const int32_t *y = passaros->y + w * 64;
+        int32_t *velocidade = passaros->velocidade + w * 64;
+        
+#if defined(__AVX2__)
+        const __m256i vlimite = _mm256_set1_epi32(limite);
+        const __m256i impulso = _mm256_set1_epi32(IMPULSO_FIXO);
+        const __m256i zero = _mm256_setzero_si256();
+        for (int i = 0; i < 64; i += LARGURA_VETOR) {
+            __m256i robo = expandir_bits((unsigned)(robos >> i) & MASCARA_VETOR);
+            __m256i linha = _mm256_srai_epi32(_mm256_load_si256((const __m256i *)(y + i)), BITS_FRACAO);
+            __m256i vv = _mm256_load_si256((const __m256i *)(velocidade + i));
+            __m256i pula = _mm256_andnot_si256(_mm256_cmpgt_epi32(zero, vv),
+                                               _mm256_and_si256(robo, _mm256_cmpgt_epi32(linha, vlimite)));
+            _mm256_store_si256((__m256i *)(velocidade + i),
+                               _mm256_or_si256(_mm256_and_si256(pula, impulso), _mm256_andnot_si256(pula, vv)));
+        }
+#elif defined(__SSE2__)
+        const __m128i vlimite = _mm_set1_epi32(limite);
+        const __m128i impulso = _mm_set1_epi32(IMPULSO_FIXO);
+        const __m128i zero = _mm_setzero_si128();
+        for (int i = 0; i < 64; i += LARGURA_VETOR) {
+            __m128i robo = expandir_bits((unsigned)(robos >> i) & MASCARA_VETOR);
+            __m128i linha = _mm_srai_epi32(_mm_load_si128((const __m128i *)(y + i)), BITS_FRACAO);
+            __m128i vv = _mm_load_si128((const __m128i *)(velocidade + i));
+            __m128i pula = _mm_andnot_si128(_mm_cmpgt_epi32(zero, vv),
+                                            _mm_and_si128(robo, _mm_cmpgt_epi32(linha, vlimite)));
+            _mm_store_si128((__m128i *)(velocidade + i),
+                            _mm_or_si128(_mm_and_si128(pula, impulso), _mm_andnot_si128(pula, vv)));
+        }
+#else
+        for (int i = 0; i < 64; i++) {
+            if ((robos >> i & 1) && linha_fixo(y[i]) > limite && velocidade[i] >= 0) {
+                velocidade[i] = IMPULSO_FIXO;
+            }
+        }
+#endif
+    }
+}
+
+// Avança o mundo em um quadro na ordem de avancar_jogo(): física,
+// obstáculos, pontuação e colisões, estas com o sprite de antes da
+// pontuação. Além dos kernels sobre os pássaros, o custo é o de um jogo só
+void avancar_mundo(Mundo *mundo) {
+    Passaros *passaros = &mundo->passaros;
+    Obstaculos *obstaculos = &mundo->obstaculos;
+    
+    mover_passaros(passaros);
+    
+    mundo->contador_obstaculos++;
+    mundo->fps_delay_atual = fps_delay_para_pontuacao(mundo->pontuacao);
+    if (mundo->contador_obstaculos >= 2) {
+        mundo->contador_obstaculos = 0;
+        subtrair_todos(obstaculos->x, obstaculos->num, 1);
+    }
+    
+    uint64_t novos = mascara_menores(obstaculos->x, obstaculos->num,
+                                     mundo->x - LARGURA_OBSTACULO) & ~obstaculos->passou;
+    obstaculos->passou |= novos;
+    
+    int32_t minima, maxima;
+    faixa_livre(mundo, sprite_passaro(mundo->nivel), &minima, &maxima);
+    
+    // Quem morre neste quadro ainda leva o cano que acabou de passar
+    if (novos != 0) {
+        mundo->pontuacao += __builtin_popcountll(novos);
+        mundo->nivel = mundo->pontuacao / PONTUACAO_PARA_PROXIMO_NIVEL;
+        atribuir_pontuacao(passaros, mundo->pontuacao, mundo->nivel);
+    }
+    
+    mundo->num_vivos -= colidir_passaros(passaros, minima, maxima);
+    if (mundo->num_vivos == 0) {
+        mundo->game_over = 1;
+    } else if (passaros->palavras * 64 >= 2 * mundo->num_vivos + 128) {
+        // Menos da metade das posições percorridas tem pássaro vivo
+        compactar_robos(mundo);
+    }
+    
+    repor_obstaculos(obstaculos, &mundo->gerador, mundo->capacidade_obstaculos,
+                     mundo->largura, mundo->altura);
+    mundo->quadros++;
+}
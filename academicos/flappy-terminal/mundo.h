@@ -0,0 +1,68 @@
+#ifndef MUNDO_H
+#define MUNDO_H
+
+#include <stdint.h>
+#include "jogo.h"
+
+#define MAX_PASSAROS_MUNDO 65536
+#define MAX_JOGADORES 4
+
+// Os robôs deixam de pular quando deviam com chance 1 / 2^BITS_ERRO_ROBOS por
+// quadro; sem erros, todos fariam exatamente o mesmo voo
+#define BITS_ERRO_ROBOS 4
+
+// Pássaros em estrutura de arrays, com y e velocidade em Q16.16. Os arrays
+// têm capacidade múltipla de 64 e alinhada, então cada palavra de `vivos`
+// cobre vetores inteiros; as posições além de `num` são pássaros mortos. Os
+// kernels só percorrem as `palavras` primeiras palavras, que contêm todos os
+// vivos. nivel e pontuacao são os de cada pássaro; os jogadores mortos
+// guardam os da queda
+typedef struct {
+    int32_t *y, *y_anterior;
+    int32_t *velocidade;
+    int32_t *nivel;
+    int32_t *pontuacao;
+    uint64_t *vivos;
+    int num, capacidade;
+    int palavras;
+} Passaros;
+
+// Um campo de obstáculos compartilhado por muitos pássaros na mesma coluna
+// x. Os primeiros `num_jogadores` pássaros são controlados pelo teclado e os
+// demais por robôs com a política do vão. Todos os vivos passam pelos mesmos
+// canos ao mesmo tempo, então têm a mesma pontuação e o mesmo sprite; a
+// rodada acaba quando não sobra nenhum
+typedef struct {
+    Passaros passaros;
+    Obstaculos obstaculos;
+    int capacidade_obstaculos;
+    int x;
+    int largura, altura;
+    int num_jogadores;
+    int num_vivos;
+    int pontuacao;
+    int nivel;
+    int game_over;
+    int contador_obstaculos;
+    int fps_delay_atual;
+    int bits_erro;
+    long quadros;
+    uint64_t semente;
+    Gerador gerador;
+    Aleatorio aleatorio_robos;
+} Mundo;
+
+static inline int passaro_vivo(const Passaros *passaros, int i) {
+    return (int)(passaros->vivos[i / 64] >> (i % 64) & 1);
+}
+
+int inicializar_mundo(Mundo *mundo, int num_passaros, int num_jogadores, uint64_t semente,
+                      int largura, int altura, int dificuldade);
+void reiniciar_mundo(Mundo *mundo, uint64_t semente);
+void redimensionar_mundo(Mundo *mundo, int largura, int altura);
+void liberar_mundo(Mundo *mundo);
+void pular_passaro(Mundo *mundo, int indice);
+void pular_robos(Mundo *mundo);
+void avancar_mundo(Mundo *mundo);
+
+#endif
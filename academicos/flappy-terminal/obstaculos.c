@@ -0,0 +1,86 @@
+#include <string.h>
+#include "obstaculos.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define LARGURA_VETOR 8
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define LARGURA_VETOR 4
+#else
+#define LARGURA_VETOR 1
+#endif
+
+_Static_assert(MAX_OBSTACULOS % LARGURA_VETOR == 0, "arrays devem ter vetores inteiros");
+
+// Máscara dos índices k < num com valores[k] < limite. Os arrays têm
+// MAX_OBSTACULOS posições, então o último vetor pode ser lido inteiro
+uint64_t mascara_menores(const int32_t *valores, int num, int32_t limite) {
+    uint64_t mascara = 0;
+#if defined(__AVX2__)
+    __m256i vlimite = _mm256_set1_epi32(limite);
+    for (int k = 0; k < num; k += LARGURA_VETOR) {
+        __m256i v = _mm256_load_si256((const __m256i *)(valores + k));
+        __m256i menores = _mm256_cmpgt_epi32(vlimite, v);
+        mascara |= (uint64_t)_mm256_movemask_ps(_mm256_castsi256_ps(menores)) << k;
+    }
+#elif defined(__SSE2__)
+    __m128i vlimite = _mm_set1_epi32(limite);
+    for (int k = 0; k < num; k += LARGURA_VETOR) {
+        __m128i v = _mm_load_si128((const __m128i *)(valores + k));
+        __m128i menores = _mm_cmpgt_epi32(vlimite, v);
+        mascara |= (uint64_t)_mm_movemask_ps(_mm_castsi128_ps(menores)) << k;
+    }
+#else
+    for (int k = 0; k < num; k++) {
+        mascara |= (uint64_t)(valores[k] < limite) << k;
+    }
+#endif
+    return mascara & mascara_ativos(num);
+}
+
+// Subtrai o mesmo valor das posições [0, num), vetor a vetor
+void subtrair_todos(int32_t *valores, int num, int32_t valor) {
+#if defined(__AVX2__)
+    __m256i vvalor = _mm256_set1_epi32(valor);
+    for (int k = 0; k < num; k += LARGURA_VETOR) {
+        __m256i *p = (__m256i *)(valores + k);
+        _mm256_store_si256(p, _mm256_sub_epi32(_mm256_load_si256(p), vvalor));
+    }
+#elif defined(__SSE2__)
+    __m128i vvalor = _mm_set1_epi32(valor);
+    for (int k = 0; k < num; k += LARGURA_VETOR) {
+        __m128i *p = (__m128i *)(valores + k);
+        _mm_store_si128(p, _mm_sub_epi32(_mm_load_si128(p), vvalor));
+    }
+#else
+    for (int k = 0; k < num; k++) {
+        valores[k] -= valor;
+    }
+#endif
+}
+
+// Remove os primeiros obstáculos (os que saíram pela esquerda), mantendo os
+// demais contíguos a partir do índice 0
+void remover_primeiros(Obstaculos *obstaculos, int quantidade) {
+    int restantes = obstaculos->num - quantidade;
+
+    memmove(obstaculos->x, obstaculos->x + quantidade, restantes * sizeof(int32_t));
+    memmove(obstaculos->altura_superior, obstaculos->altura_superior + quantidade,
+            restantes * sizeof(int32_t));
+    memmove(obstaculos->altura_inferior, obstaculos->altura_inferior + quantidade,
+            restantes * sizeof(int32_t));
+    obstaculos->passou = quantidade >= 64 ? 0 : obstaculos->passou >> quantidade;
+    obstaculos->num = restantes;
+}
+
+// Nome do conjunto de instruções usado pelos kernels nesta compilação
+const char *kernel_obstaculos(void) {
+#if defined(__AVX2__)
+    return "avx2";
+#elif defined(__SSE2__)
+    return "sse2";
+#else
+    return "escalar";
+#endif
+}
@@ -0,0 +1,32 @@
+#ifndef OBSTACULOS_H
+#define OBSTACULOS_H
+
+#include <stdint.h>
+
+#define MAX_OBSTACULOS 64
+
+// Obstáculos em estrutura de arrays, contíguos a partir do índice 0 e
+// ordenados por x. Cada array tem MAX_OBSTACULOS posições alinhadas, então os
+// kernels vetoriais leem vetores inteiros mesmo além de `num`; o bit k de
+// `passou` indica que o obstáculo k já contou ponto
+typedef struct {
+    _Alignas(32) int32_t x[MAX_OBSTACULOS];
+    _Alignas(32) int32_t altura_superior[MAX_OBSTACULOS];
+    _Alignas(32) int32_t altura_inferior[MAX_OBSTACULOS];
+    uint64_t passou;
+    int num;
+} Obstaculos;
+
+_Static_assert(MAX_OBSTACULOS <= 64, "passou é uma máscara de 64 bits");
+
+// Máscara com os bits [0, num) ligados
+static inline uint64_t mascara_ativos(int num) {
+    return num >= 64 ? ~0ULL : (1ULL << num) - 1;
+}
+
+uint64_t mascara_menores(const int32_t *valores, int num, int32_t limite);
+void subtrair_todos(int32_t *valores, int num, int32_t valor);
+void remover_primeiros(Obstaculos *obstaculos, int quantidade);
+const char *kernel_obstaculos(void);
+
+#endif
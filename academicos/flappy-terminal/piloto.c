@@ -0,0 +1,125 @@
+#include <stdlib.h>
+#include <string.h>
+#include "piloto.h"
+
+#define MASCARA_TABELA_PILOTO ((1u << BITS_TABELA_PILOTO) - 1)
+#define BITS_CAMPO_CHAVE 20
+#define MASCARA_CAMPO_CHAVE ((1ULL << BITS_CAMPO_CHAVE) - 1)
+
+// Aloca a pilha de busca e a tabela de transposição; retorna 0 em sucesso
+int inicializar_piloto(Piloto *piloto, int horizonte) {
+    piloto->horizonte = horizonte;
+    piloto->pilha = malloc(sizeof(Jogo) * (horizonte + 1));
+    piloto->tabela = calloc(MASCARA_TABELA_PILOTO + 1, sizeof(EntradaPiloto));
+    if (piloto->pilha == NULL || piloto->tabela == NULL) {
+        liberar_piloto(piloto);
+        return -1;
+    }
+    piloto->geracao = 0;
+    reiniciar_piloto(piloto);
+    piloto->decisoes = piloto->nos = piloto->acertos = 0;
+    return 0;
+}
+
+void liberar_piloto(Piloto *piloto) {
+    free(piloto->pilha);
+    free(piloto->tabela);
+    piloto->pilha = NULL;
+    piloto->tabela = NULL;
+}
+
+// Esquece a partida anterior: trocar de geração esvazia a tabela sem
+// percorrê-la
+void reiniciar_piloto(Piloto *piloto) {
+    piloto->geracao++;
+    piloto->semente = 0;
+    piloto->ultimo_quadro = -1;
+}
+
+// Chave do estado: quadro, y e velocidade quantizados, 20 bits cada
+static uint64_t chave_estado(const Jogo *jogo) {
+    uint64_t quadro = (uint64_t)jogo->quadros & MASCARA_CAMPO_CHAVE;
+    uint64_t y = (uint64_t)(jogo->passaro.y >> QUANTIZACAO_PILOTO) & MASCARA_CAMPO_CHAVE;
+    uint64_t velocidade = (uint64_t)(jogo->passaro.velocidade >> QUANTIZACAO_PILOTO) & MASCARA_CAMPO_CHAVE;
+    return quadro << (2 * BITS_CAMPO_CHAVE) | y << BITS_CAMPO_CHAVE | velocidade;
+}
+
+static EntradaPiloto *entrada_estado(Piloto *piloto, uint64_t chave) {
+    uint64_t espalhada = chave * 0x9E3779B97F4A7C15ULL;
+    return &piloto->tabela[(espalhada >> (64 - BITS_TABELA_PILOTO)) & MASCARA_TABELA_PILOTO];
+}
+
+// Maior quadro (absoluto, limitado a `alvo`) até o qual o estado da pilha no
+// nível `nivel` sobrevive com a melhor sequência de pulos. Para no primeiro
+// filho que alcança o alvo e grava o resultado na tabela
+static long explorar(Piloto *piloto, int nivel, long alvo) {
+    const Jogo *jogo = &piloto->pilha[nivel];
+    if (jogo->quadros >= alvo) {
+        return alvo;
+    }
+    
+    uint64_t chave = chave_estado(jogo);
+    EntradaPiloto *entrada = entrada_estado(piloto, chave);
+    if (entrada->chave == chave && entrada->geracao == piloto->geracao &&
+        (entrada->morre || entrada->alcance >= alvo)) {
+        piloto->acertos++;
+        return entrada->alcance < alvo ? entrada->alcance : alvo;
+    }
+    
+    long melhor = jogo->quadros;
+    Jogo *filho = &piloto->pilha[nivel + 1];
+    for (int pulo = 0; pulo <= 1 && melhor < alvo; pulo++) {
+        *filho = *jogo;
+        if (pulo) {
+            pular(filho);
+        }
+        avancar_jogo(filho);
+        piloto->nos++;
+        
+        long alcance = filho->game_over ? jogo->quadros : explorar(piloto, nivel + 1, alvo);
+        if (alcance > melhor) {
+            melhor = alcance;
+        }
+    }
+    
+    // A entrada pode ter sido reaproveitada pelos filhos; é sobrescrita agora
+    entrada->chave = chave;
+    entrada->geracao = piloto->geracao;
+    entrada->morre = melhor < alvo;
+    entrada->alcance = melhor;
+    return melhor;
+}
+
+// Decide se o pássaro pula neste quadro: não pular é preferido quando as
+// duas jogadas sobrevivem ao horizonte; se nenhuma sobrevive, fica a que vai
+// mais longe. Uma partida nova (outra semente ou quadro que voltou) esvazia
+// a tabela
+int decidir_piloto(Piloto *piloto, const Jogo *jogo) {
+    if (jogo->semente != piloto->semente || jogo->quadros < piloto->ultimo_quadro) {
+        reiniciar_piloto(piloto);
+        piloto->semente = jogo->semente;
+    }
+    piloto->ultimo_quadro = jogo->quadros;
+    piloto->decisoes++;
+    
+    long alvo = jogo->quadros + piloto->horizonte;
+    long melhor = -1;
+    int decisao = 0;
+    
+    for (int pulo = 0; pulo <= 1 && melhor < alvo; pulo++) {
+        Jogo *filho = &piloto->pilha[0];
+        *filho = *jogo;
+        if (pulo) {
+            pular(filho);
+        }
+        avancar_jogo(filho);
+        piloto->nos++;
+        
+        long alcance = filho->game_over ? jogo->quadros : explorar(piloto, 0, alvo);
+        if (alcance > melhor) {
+            melhor = alcance;
+            decisao = pulo;
+        }
+    }
+    return decisao;
+}
@@ -0,0 +1,48 @@
+#ifndef PILOTO_H
+#define PILOTO_H
+
+#include <stdint.h>
+#include "jogo.h"
+
+#define HORIZONTE_PILOTO_PADRAO 48
+#define HORIZONTE_PILOTO_MAXIMO 1024
+#define BITS_TABELA_PILOTO 16
+
+// Bits de fração descartados de y e da velocidade na chave da tabela (8 =
+// 1/256 de linha): estados mais próximos que isso são tratados como iguais
+#define QUANTIZACAO_PILOTO 8
+
+// Entrada da tabela de transposição: o estado da chave, com a melhor
+// jogada, chega vivo até o quadro `alcance`. Se `morre`, a busca foi até
+// além disso e não há jogada que sobreviva mais
+typedef struct {
+    uint64_t chave;
+    uint32_t geracao;
+    uint32_t morre;
+    long alcance;
+} EntradaPiloto;
+
+// Piloto automático por busca: explora pular/não pular nos próximos
+// `horizonte` quadros com a física real (cópias de Jogo e avancar_jogo).
+// Os canos não dependem do pássaro, então dentro de uma partida o número do
+// quadro determina a posição de todos eles, e o estado é só (quadro, y,
+// velocidade). A tabela guarda o alcance em quadros absolutos, então a busca
+// do quadro seguinte reaproveita quase tudo da anterior
+typedef struct {
+    int horizonte;
+    Jogo *pilha;              // horizonte + 1 cópias, uma por nível da busca
+    EntradaPiloto *tabela;    // 1 << BITS_TABELA_PILOTO entradas
+    uint32_t geracao;         // entradas de outra geração estão vazias
+    uint64_t semente;
+    long ultimo_quadro;
+    long long decisoes;
+    long long nos;
+    long long acertos;
+} Piloto;
+
+int inicializar_piloto(Piloto *piloto, int horizonte);
+void liberar_piloto(Piloto *piloto);
+void reiniciar_piloto(Piloto *piloto);
+int decidir_piloto(Piloto *piloto, const Jogo *jogo);
+
+#endif
@@ -0,0 +1,389 @@
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <sched.h>
+#include <signal.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "placar.h"
+#include "metricas.h"
+
+#define MAGICO_PLACAR "FBPLACAR"
+#define VERSAO_PLACAR 1
+
+// Os contadores são atualizados por vários processos no mesmo mapeamento
+_Static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2,
+               "o placar precisa de atômicos sem trava");
+
+typedef struct {
+    int32_t pontuacao;
+    int32_t nivel;
+    int64_t quadros;
+    int64_t instante;
+    uint64_t semente;
+} Recorde;
+
+typedef struct {
+    int32_t num;
+    int32_t reservado;
+    Recorde recordes[MAX_RECORDES_PLACAR];
+} ListaRecordes;
+
+// Duas cópias da lista: quem insere escreve a inativa e só então incrementa
+// `geracao`, que escolhe a ativa. Um processo morto no meio da escrita deixa
+// a ativa intacta, e quem lê repete a cópia se a geração mudou durante ela.
+// `minimo` é a pontuação que uma partida precisa superar para entrar
+typedef struct {
+    _Atomic uint64_t geracao;
+    _Atomic int32_t minimo;
+    int32_t reservado;
+    ListaRecordes copias[2];
+} TabelaRecordes;
+
+// Partidas encerradas por nível e causa (FIM_NENHUM para as interrompidas);
+// quantas chegaram a um nível é a soma das que terminaram nele ou depois
+typedef struct {
+    _Atomic uint64_t partidas;
+    _Atomic uint64_t quadros;
+    _Atomic uint64_t fins[MAX_NIVEIS_PLACAR][NUM_CAUSAS_FIM];
+} EstatisticasOrigem;
+
+typedef struct {
+    int64_t instante;
+    uint64_t quadros_escritos;
+    uint64_t quadros_descartados;
+    uint64_t quadros_coalescidos;
+    int64_t p50_ns, p99_ns, maximo_ns;
+} ResumoSessao;
+
+// Registro do anel de sessões: `confirmado` é o número da sessão + 1 depois
+// que o resumo foi escrito inteiro e 0 enquanto está sendo escrito
+typedef struct {
+    _Atomic uint64_t confirmado;
+    ResumoSessao resumo;
+} RegistroSessao;
+
+// Layout do arquivo, de tamanho fixo e mapeado inteiro. `trava` guarda o pid
+// de quem está inserindo um recorde
+typedef struct {
+    char magico[8];
+    uint32_t versao;
+    uint32_t tamanho;
+    _Atomic uint64_t trava;
+    _Atomic uint64_t proxima_sessao;
+    TabelaRecordes recordes[NUM_ORIGENS];
+    EstatisticasOrigem estatisticas[NUM_ORIGENS];
+    RegistroSessao sessoes[MAX_SESSOES_PLACAR];
+} ArquivoPlacar;
+
+static ArquivoPlacar *placar = NULL;
+static char caminho_placar[256];
+
+static const char *nomes_origens[NUM_ORIGENS] = { "jogador", "piloto", "simulacao" };
+
+// Caminho do placar sem --scores: $XDG_STATE_HOME/flappy-terminal ou
+// ~/.local/state/flappy-terminal, criando os diretórios que faltarem. Sem
+// nenhuma das duas variáveis, fica no diretório atual
+const char *caminho_placar_padrao(void) {
+    static char caminho[512];
+    const char *estado = getenv("XDG_STATE_HOME");
+    const char *casa = getenv("HOME");
+    int tamanho;
+    
+    if (estado != NULL && estado[0] == '/') {
+        tamanho = snprintf(caminho, sizeof(caminho), "%s/flappy-terminal/", estado);
+    } else if (casa != NULL && casa[0] != '\0') {
+        tamanho = snprintf(caminho, sizeof(caminho), "%s/.local/state/flappy-terminal/", casa);
+    } else {
+        return NOME_PLACAR_PADRAO;
+    }
+    if (tamanho < 0 || (size_t)tamanho + sizeof(NOME_PLACAR_PADRAO) > sizeof(caminho)) {
+        return NOME_PLACAR_PADRAO;
+    }
+    
+    // mkdir -p: cada prefixo até uma barra; os que já existem só falham com EEXIST
+    for (char *barra = strchr(caminho + 1, '/'); barra != NULL; barra = strchr(barra + 1, '/')) {
+        *barra = '\0';
+        mkdir(caminho, 0755);
+        *barra = '/';
+    }
+    strcat(caminho, NOME_PLACAR_PADRAO);
+    return caminho;
+}
+
+// Mapeia o placar do caminho dado, criando-o se não existir. O custo não
+// depende do histórico: o arquivo tem sempre o mesmo tamanho e só o
+// cabeçalho é conferido. Retorna 0 ou -1 com a mensagem em stderr
+int abrir_placar(const char *caminho) {
+    if (placar != NULL) {
+        return 0;
+    }
+    int descritor = open(caminho, O_RDWR | O_CREAT, 0644);
+    if (descritor < 0) {
+        fprintf(stderr, "Erro: nao foi possivel abrir o placar %s\n", caminho);
+        return -1;
+    }
+    
+    // Serializa a criação entre processos que abrem o mesmo arquivo juntos
+    flock(descritor, LOCK_EX);
+    ArquivoPlacar *mapa = MAP_FAILED;
+    struct stat info;
+    if (fstat(descritor, &info) == 0 &&
+        (info.st_size == (off_t)sizeof(ArquivoPlacar) ||
+         (info.st_size == 0 && ftruncate(descritor, sizeof(ArquivoPlacar)) == 0))) {
+        mapa = mmap(NULL, sizeof(ArquivoPlacar), PROT_READ | PROT_WRITE, MAP_SHARED, descritor, 0);
+    }
+    if (mapa != MAP_FAILED) {
+        static const char vazio[8];
+        if (memcmp(mapa->magico, vazio, sizeof(vazio)) == 0) {
+            // Arquivo novo, ou criado por um processo que morreu antes do
+            // cabeçalho: o resto ainda é zero, que já é um placar vazio
+            mapa->versao = VERSAO_PLACAR;
+            mapa->tamanho = sizeof(ArquivoPlacar);
+            memcpy(mapa->magico, MAGICO_PLACAR, sizeof(mapa->magico));
+        } else if (memcmp(mapa->magico, MAGICO_PLACAR, sizeof(mapa->magico)) != 0 ||
+                   mapa->versao != VERSAO_PLACAR || mapa->tamanho != sizeof(ArquivoPlacar)) {
+            munmap(mapa, sizeof(ArquivoPlacar));
+            mapa = MAP_FAILED;
+        }
+    }
+    flock(descritor, LOCK_UN);
+    close(descritor);
+    if (mapa == MAP_FAILED) {
+        fprintf(stderr, "Erro: %s nao e um placar valido desta versao\n", caminho);
+        return -1;
+    }
+    
+    placar = mapa;
+    snprintf(caminho_placar, sizeof(caminho_placar), "%s", caminho);
+    return 0;
+}
+
+// Desfaz o mapeamento; o page cache grava o que faltar no disco
+void fechar_placar(void) {
+    if (placar == NULL) {
+        return;
+    }
+    msync(placar, sizeof(ArquivoPlacar), MS_ASYNC);
+    munmap(placar, sizeof(ArquivoPlacar));
+    placar = NULL;
+}
+
+// Trava das inserções de recordes, entre threads e processos. Um dono que
+// morreu com ela (kill -9 no meio da inserção) não a prende para sempre:
+// quem o encontra morto toma a trava para si
+static void travar_recordes(void) {
+    uint64_t dono = (uint64_t)getpid();
+    uint64_t atual = 0;
+    while (!atomic_compare_exchange_weak_explicit(&placar->trava, &atual, dono,
+                                                  memory_order_acquire, memory_order_relaxed)) {
+        if (atual != 0 && atual != dono && kill((pid_t)atual, 0) != 0 && errno == ESRCH &&
+            atomic_compare_exchange_strong_explicit(&placar->trava, &atual, dono,
+                                                    memory_order_acquire, memory_order_relaxed)) {
+            return;
+        }
+        atual = 0;
+        sched_yield();
+    }
+}
+
+static void destravar_recordes(void) {
+    atomic_store_explicit(&placar->trava, 0, memory_order_release);
+}
+
+// Copia a lista ativa de forma consistente com escritores concorrentes
+static void ler_recordes(const TabelaRecordes *tabela, ListaRecordes *destino) {
+    while (1) {
+        uint64_t geracao = atomic_load_explicit(&tabela->geracao, memory_order_acquire);
+        memcpy(destino, &tabela->copias[geracao & 1], sizeof(*destino));
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&tabela->geracao, memory_order_relaxed) == geracao) {
+            return;
+        }
+    }
+}
+
+// Insere o recorde em ordem de pontuação, se ele couber na lista
+static void inserir_recorde(TabelaRecordes *tabela, const Recorde *recorde) {
+    if (recorde->pontuacao <= atomic_load_explicit(&tabela->minimo, memory_order_relaxed)) {
+        return;
+    }
+    
+    travar_recordes();
+    uint64_t geracao = atomic_load_explicit(&tabela->geracao, memory_order_relaxed);
+    const ListaRecordes *ativa = &tabela->copias[geracao & 1];
+    ListaRecordes *nova = &tabela->copias[(geracao + 1) & 1];
+    
+    int posicao = 0;
+    while (posicao < ativa->num && ativa->recordes[posicao].pontuacao >= recorde->pontuacao) {
+        posicao++;
+    }
+    if (posicao < MAX_RECORDES_PLACAR) {
+        int num = ativa->num < MAX_RECORDES_PLACAR ? ativa->num + 1 : MAX_RECORDES_PLACAR;
+        memcpy(nova->recordes, ativa->recordes, posicao * sizeof(Recorde));
+        nova->recordes[posicao] = *recorde;
+        memcpy(&nova->recordes[posicao + 1], &ativa->recordes[posicao],
+               (num - posicao - 1) * sizeof(Recorde));
+        nova->num = num;
+        
+        atomic_store_explicit(&tabela->geracao, geracao + 1, memory_order_release);
+        atomic_store_explicit(&tabela->minimo,
+                              num == MAX_RECORDES_PLACAR ? nova->recordes[num - 1].pontuacao : 0,
+                              memory_order_relaxed);
+    }
+    destravar_recordes();
+}
+
+// Conta uma partida encerrada nas estatísticas e, se for o caso, nos
+// recordes. Seguro para chamar de várias threads e processos ao mesmo tempo;
+// sem placar aberto não faz nada
+void registrar_partida_placar(OrigemPartida origem, const Jogo *jogo) {
+    if (placar == NULL) {
+        return;
+    }
+    int nivel = jogo->passaro.nivel_evolucao;
+    if (nivel >= MAX_NIVEIS_PLACAR) {
+        nivel = MAX_NIVEIS_PLACAR - 1;
+    }
+    CausaFim causa = jogo->game_over ? jogo->causa_fim : FIM_NENHUM;
+    
+    EstatisticasOrigem *estatisticas = &placar->estatisticas[origem];
+    atomic_fetch_add_explicit(&estatisticas->partidas, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&estatisticas->quadros, (uint64_t)jogo->quadros, memory_order_relaxed);
+    atomic_fetch_add_explicit(&estatisticas->fins[nivel][causa], 1, memory_order_relaxed);
+    
+    Recorde recorde = {
+        .pontuacao = jogo->pontuacao,
+        .nivel = jogo->passaro.nivel_evolucao,
+        .quadros = jogo->quadros,
+        .instante = (int64_t)time(NULL),
+        .semente = jogo->semente,
+    };
+    inserir_recorde(&placar->recordes[origem], &recorde);
+}
+
+// Guarda o resumo dos tempos de quadro desta sessão no anel de sessões
+void registrar_sessao_placar(void) {
+    if (placar == NULL || total_quadros_escritos() == 0) {
+        return;
+    }
+    uint64_t numero = atomic_fetch_add_explicit(&placar->proxima_sessao, 1, memory_order_relaxed);
+    RegistroSessao *registro = &placar->sessoes[numero % MAX_SESSOES_PLACAR];
+    
+    atomic_store_explicit(&registro->confirmado, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    registro->resumo = (ResumoSessao){
+        .instante = (int64_t)time(NULL),
+        .quadros_escritos = total_quadros_escritos(),
+        .quadros_descartados = total_quadros_descartados(),
+        .quadros_coalescidos = total_quadros_coalescidos(),
+        .p50_ns = percentil_fase(FASE_QUADRO, 50.0),
+        .p99_ns = percentil_fase(FASE_QUADRO, 99.0),
+        .maximo_ns = percentil_fase(FASE_QUADRO, 100.0),
+    };
+    atomic_store_explicit(&registro->confirmado, numero + 1, memory_order_release);
+}
+
+// Maior pontuação já registrada pela origem, 0 sem nenhuma ou -1 sem placar aberto
+int maior_pontuacao_placar(OrigemPartida origem) {
+    if (placar == NULL) {
+        return -1;
+    }
+    ListaRecordes lista;
+    ler_recordes(&placar->recordes[origem], &lista);
+    return lista.num > 0 ? lista.recordes[0].pontuacao : 0;
+}
+
+static void formatar_instante(int64_t instante, char *texto, size_t tamanho) {
+    time_t segundos = (time_t)instante;
+    struct tm data;
+    localtime_r(&segundos, &data);
+    strftime(texto, tamanho, "%Y-%m-%d %H:%M", &data);
+}
+
+// Imprime recordes e sobrevivência por nível de cada origem e as últimas sessões
+void imprimir_placar(FILE *saida) {
+    if (placar == NULL) {
+        return;
+    }
+    char data[32];
+    fprintf(saida, "placar: %s\n", caminho_placar);
+    
+    for (int origem = 0; origem < NUM_ORIGENS; origem++) {
+        EstatisticasOrigem *estatisticas = &placar->estatisticas[origem];
+        uint64_t partidas = atomic_load_explicit(&estatisticas->partidas, memory_order_relaxed);
+        if (partidas == 0) {
+            continue;
+        }
+        uint64_t quadros = atomic_load_explicit(&estatisticas->quadros, memory_order_relaxed);
+        fprintf(saida, "\n%s: %llu partidas, %.1f quadros em media\n", nomes_origens[origem],
+                (unsigned long long)partidas, (double)quadros / partidas);
+        
+        ListaRecordes lista;
+        ler_recordes(&placar->recordes[origem], &lista);
+        for (int i = 0; i < lista.num; i++) {
+            const Recorde *recorde = &lista.recordes[i];
+            formatar_instante(recorde->instante, data, sizeof(data));
+            fprintf(saida, "  %2d. %5d pontos  nivel %2d  %7lld quadros  %s  semente %llu\n",
+                    i + 1, recorde->pontuacao, recorde->nivel, (long long)recorde->quadros, data,
+                    (unsigned long long)recorde->semente);
+        }
+        
+        // Percorre os níveis de trás para frente acumulando quem chegou a cada um
+        uint64_t terminaram[MAX_NIVEIS_PLACAR];
+        uint64_t chegaram[MAX_NIVEIS_PLACAR];
+        uint64_t acumulado = 0;
+        for (int nivel = MAX_NIVEIS_PLACAR - 1; nivel >= 0; nivel--) {
+            terminaram[nivel] = 0;
+            for (int causa = 0; causa < NUM_CAUSAS_FIM; causa++) {
+                terminaram[nivel] += atomic_load_explicit(&estatisticas->fins[nivel][causa],
+                                                          memory_order_relaxed);
+            }
+            acumulado += terminaram[nivel];
+            chegaram[nivel] = acumulado;
+        }
+        fprintf(saida, "  nivel  chegaram  terminaram  sobreviveram\n");
+        for (int nivel = 0; nivel < MAX_NIVEIS_PLACAR && chegaram[nivel] > 0; nivel++) {
+            if (nivel == MAX_NIVEIS_PLACAR - 1) {
+                fprintf(saida, "  >=%3d %9llu\n", nivel, (unsigned long long)chegaram[nivel]);
+                break;
+            }
+            fprintf(saida, "    %3d %9llu %11llu %12.1f%%\n", nivel,
+                    (unsigned long long)chegaram[nivel], (unsigned long long)terminaram[nivel],
+                    100.0 * (chegaram[nivel] - terminaram[nivel]) / chegaram[nivel]);
+        }
+    }
+    
+    uint64_t proxima = atomic_load_explicit(&placar->proxima_sessao, memory_order_relaxed);
+    if (proxima == 0) {
+        return;
+    }
+    fprintf(saida, "\nsessoes recentes (tempo de quadro):\n");
+    uint64_t primeira = proxima > MAX_SESSOES_PLACAR ? proxima - MAX_SESSOES_PLACAR : 0;
+    for (uint64_t numero = primeira; numero < proxima; numero++) {
+        RegistroSessao *registro = &placar->sessoes[numero % MAX_SESSOES_PLACAR];
+        if (atomic_load_explicit(&registro->confirmado, memory_order_acquire) != numero + 1) {
+            continue;
+        }
+        ResumoSessao resumo = registro->resumo;
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&registro->confirmado, memory_order_relaxed) != numero + 1) {
+            continue;
+        }
+        formatar_instante(resumo.instante, data, sizeof(data));
+        fprintf(saida, "  %s  %7llu quadros  p50 %6.2f ms  p99 %6.2f ms  max %7.2f ms"
+                "  descartados %llu  coalescidos %llu\n",
+                data, (unsigned long long)resumo.quadros_escritos, resumo.p50_ns / 1e6,
+                resumo.p99_ns / 1e6, resumo.maximo_ns / 1e6,
+                (unsigned long long)resumo.quadros_descartados,
+                (unsigned long long)resumo.quadros_coalescidos);
+    }
+}
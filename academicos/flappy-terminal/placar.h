@@ -0,0 +1,29 @@
+#ifndef PLACAR_H
+#define PLACAR_H
+
+#include <stdio.h>
+#include "jogo.h"
+
+#define NOME_PLACAR_PADRAO "placar.fbpl"
+#define MAX_RECORDES_PLACAR 16
+#define MAX_NIVEIS_PLACAR 32
+#define MAX_SESSOES_PLACAR 64
+
+// Quem jogou a partida: recordes e estatísticas são separados por origem,
+// para que milhões de partidas simuladas não escondam as de pessoas
+typedef enum {
+    ORIGEM_JOGADOR,
+    ORIGEM_PILOTO,
+    ORIGEM_SIMULACAO,
+    NUM_ORIGENS
+} OrigemPartida;
+
+const char *caminho_placar_padrao(void);
+int abrir_placar(const char *caminho);
+void fechar_placar(void);
+void registrar_partida_placar(OrigemPartida origem, const Jogo *jogo);
+void registrar_sessao_placar(void);
+int maior_pontuacao_placar(OrigemPartida origem);
+void imprimir_placar(FILE *saida);
+
+#endif
@@ -0,0 +1,196 @@
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "rede.h"
+#include "sprite.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Preenche as observações da rede a partir do estado da partida. Sem cano à
+// frente, o vão é o meio do campo a uma distância de um espaçamento
+void observar_jogo(const Jogo *jogo, float observacao[ENTRADAS_REDE]) {
+    const Obstaculos *obstaculos = &jogo->obstaculos;
+    const Sprite *sprite = sprite_passaro(jogo->passaro.nivel_evolucao);
+    float y = (float)jogo->passaro.y / UM_FIXO;
+    float centro_passaro = y + (sprite->topo + sprite->base) * 0.5f;
+    float distancia = 1.0f;
+    float centro_vao = jogo->altura * 0.5f;
+    float vao = (float)jogo->altura;
+    
+    int k = proximo_obstaculo(jogo);
+    if (k < obstaculos->num) {
+        int inicio_inferior = jogo->altura - obstaculos->altura_inferior[k];
+        distancia = (float)(obstaculos->x[k] + LARGURA_OBSTACULO - jogo->passaro.x) / ESPACAMENTO_OBSTACULOS;
+        centro_vao = (obstaculos->altura_superior[k] + inicio_inferior) * 0.5f;
+        vao = (float)(inicio_inferior - obstaculos->altura_superior[k]);
+    }
+    
+    observacao[0] = y / jogo->altura;
+    observacao[1] = (float)jogo->passaro.velocidade / UM_FIXO;
+    observacao[2] = distancia;
+    observacao[3] = (centro_vao - centro_passaro) / vao;
+    observacao[4] = (float)(sprite->base - sprite->topo + 1) / ALTURA_SPRITE;
+}
+
+// Passada de uma única rede, com as operações na mesma ordem dos kernels de
+// bloco: a decisão é idêntica à do treino em qualquer conjunto de instruções
+int decidir_rede(const Rede *rede, const Jogo *jogo) {
+    float observacao[ENTRADAS_REDE];
+    observar_jogo(jogo, observacao);
+    
+    float saida = rede->b2;
+    for (int h = 0; h < OCULTOS_REDE; h++) {
+        float soma = rede->b1[h];
+        for (int e = 0; e < ENTRADAS_REDE; e++) {
+            soma = soma + rede->w1[h][e] * observacao[e];
+        }
+        saida = saida + rede->w2[h] * (soma / (1.0f + fabsf(soma)));
+    }
+    return saida > 0.0f;
+}
+
+// Transpõe até LARGURA_BLOCO_REDES redes para um bloco; pistas sem rede
+// ficam com pesos zero e nunca pulam
+void empacotar_bloco(BlocoRedes *bloco, const Rede *redes, int num) {
+    memset(bloco, 0, sizeof(*bloco));
+    for (int p = 0; p < num; p++) {
+        const Rede *rede = &redes[p];
+        for (int h = 0; h < OCULTOS_REDE; h++) {
+            for (int e = 0; e < ENTRADAS_REDE; e++) {
+                bloco->w1[h][e][p] = rede->w1[h][e];
+            }
+            bloco->b1[h][p] = rede->b1[h];
+            bloco->w2[h][p] = rede->w2[h];
+        }
+        bloco->b2[p] = rede->b2;
+    }
+}
+
+// Passada das redes de um bloco sobre as observações de cada uma; o bit p
+// do resultado indica que a rede p pulou
+unsigned decidir_bloco(const BlocoRedes *bloco, const ObservacoesBloco *observacoes) {
+#if defined(__AVX2__)
+    const __m256 um = _mm256_set1_ps(1.0f);
+    const __m256 sinal = _mm256_set1_ps(-0.0f);
+    __m256 saida = _mm256_load_ps(bloco->b2);
+    for (int h = 0; h < OCULTOS_REDE; h++) {
+        __m256 soma = _mm256_load_ps(bloco->b1[h]);
+        for (int e = 0; e < ENTRADAS_REDE; e++) {
+            soma = _mm256_add_ps(soma, _mm256_mul_ps(_mm256_load_ps(bloco->w1[h][e]),
+                                                     _mm256_load_ps(observacoes->valores[e])));
+        }
+        __m256 ativacao = _mm256_div_ps(soma, _mm256_add_ps(um, _mm256_andnot_ps(sinal, soma)));
+        saida = _mm256_add_ps(saida, _mm256_mul_ps(_mm256_load_ps(bloco->w2[h]), ativacao));
+    }
+    return (unsigned)_mm256_movemask_ps(_mm256_cmp_ps(saida, _mm256_setzero_ps(), _CMP_GT_OQ));
+#elif defined(__SSE2__)
+    const __m128 um = _mm_set1_ps(1.0f);
+    const __m128 sinal = _mm_set1_ps(-0.0f);
+    unsigned pulos = 0;
+    for (int p = 0; p < LARGURA_BLOCO_REDES; p += 4) {
+        __m128 saida = _mm_load_ps(bloco->b2 + p);
+        for (int h = 0; h < OCULTOS_REDE; h++) {
+            __m128 soma = _mm_load_ps(bloco->b1[h] + p);
+            for (int e = 0; e < ENTRADAS_REDE; e++) {
+                soma = _mm_add_ps(soma, _mm_mul_ps(_mm_load_ps(bloco->w1[h][e] + p),
+                                                   _mm_load_ps(observacoes->valores[e] + p)));
+            }
+            __m128 ativacao = _mm_div_ps(soma, _mm_add_ps(um, _mm_andnot_ps(sinal, soma)));
+            saida = _mm_add_ps(saida, _mm_mul_ps(_mm_load_ps(bloco->w2[h] + p), ativacao));
+        }
+        pulos |= (unsigned)_mm_movemask_ps(_mm_cmpgt_ps(saida, _mm_setzero_ps())) << p;
+    }
+    return pulos;
+#else
+    unsigned pulos = 0;
+    for (int p = 0; p < LARGURA_BLOCO_REDES; p++) {
+        float saida = bloco->b2[p];
+        for (int h = 0; h < OCULTOS_REDE; h++) {
+            float soma = bloco->b1[h][p];
+            for (int e = 0; e < ENTRADAS_REDE; e++) {
+                soma = soma + bloco->w1[h][e][p] * observacoes->valores[e][p];
+            }
+            saida = saida + bloco->w2[h][p] * (soma / (1.0f + fabsf(soma)));
+        }
+        pulos |= (unsigned)(saida > 0.0f) << p;
+    }
+    return pulos;
+#endif
+}
+
+static void escrever_u16(uint8_t *destino, uint16_t valor) {
+    destino[0] = (uint8_t)valor;
+    destino[1] = (uint8_t)(valor >> 8);
+}
+
+static uint16_t ler_u16(const uint8_t *origem) {
+    return (uint16_t)(origem[0] | (origem[1] << 8));
+}
+
+// Salva os pesos da rede em arquivo; retorna 0 em sucesso
+int salvar_rede(const Rede *rede, const char *caminho) {
+    uint8_t dados[REDE_TAMANHO_CABECALHO + NUM_PESOS_REDE * 4];
+    const float *pesos = (const float *)rede;
+    
+    memcpy(dados, REDE_MAGICA, 4);
+    dados[4] = REDE_VERSAO;
+    dados[5] = dados[6] = dados[7] = 0;
+    escrever_u16(dados + 8, ENTRADAS_REDE);
+    escrever_u16(dados + 10, OCULTOS_REDE);
+    for (int i = 0; i < NUM_PESOS_REDE; i++) {
+        uint32_t bits;
+        memcpy(&bits, &pesos[i], 4);
+        for (int b = 0; b < 4; b++) {
+            dados[REDE_TAMANHO_CABECALHO + 4 * i + b] = (uint8_t)(bits >> (8 * b));
+        }
+    }
+    
+    FILE *arquivo = fopen(caminho, "wb");
+    if (arquivo == NULL) {
+        return -1;
+    }
+    size_t escrito = fwrite(dados, 1, sizeof(dados), arquivo);
+    int erro = fclose(arquivo) != 0 || escrito != sizeof(dados);
+    return erro ? -1 : 0;
+}
+
+// Carrega os pesos de uma rede salva com a mesma arquitetura; retorna 0 em sucesso
+int carregar_rede(Rede *rede, const char *caminho) {
+    uint8_t dados[REDE_TAMANHO_CABECALHO + NUM_PESOS_REDE * 4];
+    FILE *arquivo = fopen(caminho, "rb");
+    if (arquivo == NULL) {
+        return -1;
+    }
+    size_t lido = fread(dados, 1, sizeof(dados), arquivo);
+    fclose(arquivo);
+    
+    if (lido != sizeof(dados) || memcmp(dados, REDE_MAGICA, 4) != 0 || dados[4] != REDE_VERSAO ||
+        ler_u16(dados + 8) != ENTRADAS_REDE || ler_u16(dados + 10) != OCULTOS_REDE) {
+        return -1;
+    }
+    
+    float *pesos = (float *)rede;
+    for (int i = 0; i < NUM_PESOS_REDE; i++) {
+        uint32_t bits = 0;
+        for (int b = 0; b < 4; b++) {
+            bits |= (uint32_t)dados[REDE_TAMANHO_CABECALHO + 4 * i + b] << (8 * b);
+        }
+        memcpy(&pesos[i], &bits, 4);
+    }
+    return 0;
+}
+
+// Nome do conjunto de instruções usado pela passada em bloco nesta compilação
+const char *kernel_rede(void) {
+#if defined(__AVX2__)
+    return "avx2";
+#elif defined(__SSE2__)
+    return "sse2";
+#else
+    return "escalar";
+#endif
+}
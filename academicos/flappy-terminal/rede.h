@@ -0,0 +1,63 @@
+#ifndef REDE_H
+#define REDE_H
+
+#include <stdint.h>
+#include "jogo.h"
+
+#define REDE_MAGICA "FBNN"
+#define REDE_VERSAO 1
+#define REDE_TAMANHO_CABECALHO 12
+
+// Observações: altura do pássaro, velocidade, distância até o próximo cano,
+// distância vertical até o centro do vão e altura do sprite
+#define ENTRADAS_REDE 5
+#define OCULTOS_REDE 8
+
+// Redes avaliadas juntas, uma por pista de um vetor de 8 floats
+#define LARGURA_BLOCO_REDES 8
+
+// Perceptron com uma camada oculta (ativação softsign, x / (1 + |x|)) e uma
+// saída: o pássaro pula quando a saída é positiva. Só floats, sem padding,
+// então a rede também pode ser vista como um vetor de NUM_PESOS_REDE pesos
+//
+// Formato do arquivo (inteiros e floats IEEE 754 little-endian):
+//   0  "FBNN"            4 bytes
+//   4  versão             1 byte (+3 reservados)
+//   8  entradas           2 bytes
+//   10 ocultos            2 bytes
+//   12 pesos              NUM_PESOS_REDE floats, na ordem dos campos de Rede
+typedef struct {
+    float w1[OCULTOS_REDE][ENTRADAS_REDE];
+    float b1[OCULTOS_REDE];
+    float w2[OCULTOS_REDE];
+    float b2;
+} Rede;
+
+#define NUM_PESOS_REDE ((int)(sizeof(Rede) / sizeof(float)))
+
+_Static_assert(sizeof(Rede) == (OCULTOS_REDE * (ENTRADAS_REDE + 2) + 1) * sizeof(float),
+               "Rede não pode ter padding");
+
+// Um bloco de redes transposto: cada peso vira um vetor com o valor dele em
+// cada rede do bloco, então a passada é feita só com operações verticais
+typedef struct {
+    _Alignas(32) float w1[OCULTOS_REDE][ENTRADAS_REDE][LARGURA_BLOCO_REDES];
+    _Alignas(32) float b1[OCULTOS_REDE][LARGURA_BLOCO_REDES];
+    _Alignas(32) float w2[OCULTOS_REDE][LARGURA_BLOCO_REDES];
+    _Alignas(32) float b2[LARGURA_BLOCO_REDES];
+} BlocoRedes;
+
+// Observações de um bloco, transpostas como os pesos
+typedef struct {
+    _Alignas(32) float valores[ENTRADAS_REDE][LARGURA_BLOCO_REDES];
+} ObservacoesBloco;
+
+void observar_jogo(const Jogo *jogo, float observacao[ENTRADAS_REDE]);
+int decidir_rede(const Rede *rede, const Jogo *jogo);
+void empacotar_bloco(BlocoRedes *bloco, const Rede *redes, int num);
+unsigned decidir_bloco(const BlocoRedes *bloco, const ObservacoesBloco *observacoes);
+int salvar_rede(const Rede *rede, const char *caminho);
+int carregar_rede(Rede *rede, const char *caminho);
+const char *kernel_rede(void);
+
+#endif
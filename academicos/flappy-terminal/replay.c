@@ -0,0 +1,262 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "replay.h"
+
+// Prepara uma gravação vazia para a partida recém-inicializada
+void iniciar_replay(Replay *replay, const Jogo *jogo) {
+    replay->semente = jogo->semente;
+    replay->largura = (uint16_t)jogo->largura;
+    replay->altura = (uint16_t)jogo->altura;
+    replay->dificuldade = (uint8_t)jogo->gerador.dificuldade;
+    replay->quadros = 0;
+    replay->pontuacao = 0;
+    replay->num_pulos = 0;
+    if (replay->capacidade == 0) {
+        replay->pulos = NULL;
+    }
+}
+
+// Libera a lista de pulos da gravação
+void liberar_replay(Replay *replay) {
+    free(replay->pulos);
+    replay->pulos = NULL;
+    replay->num_pulos = 0;
+    replay->capacidade = 0;
+}
+
+// Registra um pulo no quadro dado; pulos repetidos no mesmo quadro têm o
+// mesmo efeito e são ignorados. Retorna 0 em sucesso
+int registrar_pulo(Replay *replay, uint32_t quadro) {
+    if (replay->num_pulos > 0 && replay->pulos[replay->num_pulos - 1] >= quadro) {
+        return 0;
+    }
+    
+    if (replay->num_pulos == replay->capacidade) {
+        uint32_t nova_capacidade = replay->capacidade ? replay->capacidade * 2 : 256;
+        uint32_t *novos = realloc(replay->pulos, nova_capacidade * sizeof(uint32_t));
+        if (novos == NULL) {
+            return -1;
+        }
+        replay->pulos = novos;
+        replay->capacidade = nova_capacidade;
+    }
+    
+    replay->pulos[replay->num_pulos++] = quadro;
+    return 0;
+}
+
+// Esquece os pulos a partir do quadro dado, quando a partida volta no tempo
+void descartar_pulos_desde(Replay *replay, uint32_t quadro) {
+    while (replay->num_pulos > 0 && replay->pulos[replay->num_pulos - 1] >= quadro) {
+        replay->num_pulos--;
+    }
+}
+
+// Guarda o resultado da partida, usado depois para detectar divergências
+void finalizar_replay(Replay *replay, const Jogo *jogo) {
+    replay->quadros = (uint32_t)jogo->quadros;
+    replay->pontuacao = jogo->pontuacao;
+}
+
+static void escrever_u32(uint8_t *destino, uint32_t valor) {
+    for (int i = 0; i < 4; i++) {
+        destino[i] = (uint8_t)(valor >> (8 * i));
+    }
+}
+
+static void escrever_u64(uint8_t *destino, uint64_t valor) {
+    for (int i = 0; i < 8; i++) {
+        destino[i] = (uint8_t)(valor >> (8 * i));
+    }
+}
+
+static void escrever_u16(uint8_t *destino, uint16_t valor) {
+    destino[0] = (uint8_t)valor;
+    destino[1] = (uint8_t)(valor >> 8);
+}
+
+static uint16_t ler_u16(const uint8_t *origem) {
+    return (uint16_t)(origem[0] | (origem[1] << 8));
+}
+
+static uint32_t ler_u32(const uint8_t *origem) {
+    uint32_t valor = 0;
+    for (int i = 0; i < 4; i++) {
+        valor |= (uint32_t)origem[i] << (8 * i);
+    }
+    return valor;
+}
+
+static uint64_t ler_u64(const uint8_t *origem) {
+    uint64_t valor = 0;
+    for (int i = 0; i < 8; i++) {
+        valor |= (uint64_t)origem[i] << (8 * i);
+    }
+    return valor;
+}
+
+static size_t escrever_varint(uint8_t *destino, uint32_t valor) {
+    size_t n = 0;
+    while (valor >= 0x80) {
+        destino[n++] = (uint8_t)(valor | 0x80);
+        valor >>= 7;
+    }
+    destino[n++] = (uint8_t)valor;
+    return n;
+}
+
+// Lê um varint; retorna o número de bytes consumidos ou 0 se truncado/inválido
+static size_t ler_varint(const uint8_t *origem, size_t disponivel, uint32_t *valor) {
+    uint32_t resultado = 0;
+    for (size_t n = 0; n < disponivel && n < 5; n++) {
+        resultado |= (uint32_t)(origem[n] & 0x7F) << (7 * n);
+        if (!(origem[n] & 0x80)) {
+            *valor = resultado;
+            return n + 1;
+        }
+    }
+    return 0;
+}
+
+// Salva a gravação em arquivo; retorna 0 em sucesso
+int salvar_replay(const Replay *replay, const char *caminho) {
+    // Cada par ocupa no máximo 10 bytes e há no máximo um par por pulo
+    uint8_t *dados = malloc(REPLAY_TAMANHO_CABECALHO + (size_t)replay->num_pulos * 10);
+    if (dados == NULL) {
+        return -1;
+    }
+    
+    size_t n = REPLAY_TAMANHO_CABECALHO;
+    uint32_t fim_anterior = 0;
+    uint32_t i = 0;
+    while (i < replay->num_pulos) {
+        uint32_t inicio = replay->pulos[i];
+        uint32_t repeticoes = 1;
+        while (i + repeticoes < replay->num_pulos &&
+               replay->pulos[i + repeticoes] == inicio + repeticoes) {
+            repeticoes++;
+        }
+        n += escrever_varint(dados + n, inicio - fim_anterior);
+        n += escrever_varint(dados + n, repeticoes);
+        fim_anterior = inicio + repeticoes;
+        i += repeticoes;
+    }
+    
+    memcpy(dados, REPLAY_MAGICA, 4);
+    dados[4] = REPLAY_VERSAO;
+    dados[5] = replay->dificuldade;
+    dados[6] = dados[7] = 0;
+    escrever_u64(dados + 8, replay->semente);
+    escrever_u32(dados + 16, replay->quadros);
+    escrever_u32(dados + 20, (uint32_t)replay->pontuacao);
+    escrever_u32(dados + 24, replay->num_pulos);
+    escrever_u32(dados + 28, (uint32_t)(n - REPLAY_TAMANHO_CABECALHO));
+    escrever_u16(dados + 32, replay->largura);
+    escrever_u16(dados + 34, replay->altura);
+    
+    FILE *arquivo = fopen(caminho, "wb");
+    if (arquivo == NULL) {
+        free(dados);
+        return -1;
+    }
+    size_t escrito = fwrite(dados, 1, n, arquivo);
+    int erro = fclose(arquivo) != 0 || escrito != n;
+    free(dados);
+    return erro ? -1 : 0;
+}
+
+// Carrega uma gravação de arquivo; retorna 0 em sucesso
+int carregar_replay(Replay *replay, const char *caminho) {
+    uint8_t cabecalho[REPLAY_TAMANHO_CABECALHO];
+    FILE *arquivo = fopen(caminho, "rb");
+    if (arquivo == NULL) {
+        return -1;
+    }
+    
+    if (fread(cabecalho, 1, sizeof(cabecalho), arquivo) != sizeof(cabecalho) ||
+        memcmp(cabecalho, REPLAY_MAGICA, 4) != 0 || cabecalho[4] != REPLAY_VERSAO) {
+        fclose(arquivo);
+        return -1;
+    }
+    
+    uint32_t num_pulos = ler_u32(cabecalho + 24);
+    uint16_t largura = ler_u16(cabecalho + 32);
+    uint16_t altura = ler_u16(cabecalho + 34);
+    if (largura < LARGURA_MINIMA || largura > LARGURA_MAXIMA ||
+        altura < ALTURA_MINIMA || altura > ALTURA_MAXIMA || cabecalho[5] >= NUM_DIFICULDADES) {
+        fclose(arquivo);
+        return -1;
+    }
+
+    uint32_t tamanho = ler_u32(cabecalho + 28);
+    uint8_t *dados = malloc(tamanho ? tamanho : 1);
+    uint32_t *pulos = malloc((num_pulos ? num_pulos : 1) * sizeof(uint32_t));
+    if (dados == NULL || pulos == NULL || fread(dados, 1, tamanho, arquivo) != tamanho) {
+        free(dados);
+        free(pulos);
+        fclose(arquivo);
+        return -1;
+    }
+    fclose(arquivo);
+    
+    size_t pos = 0;
+    uint32_t lidos = 0;
+    uint32_t fim_anterior = 0;
+    while (pos < tamanho) {
+        uint32_t intervalo, repeticoes;
+        size_t n1 = ler_varint(dados + pos, tamanho - pos, &intervalo);
+        size_t n2 = n1 ? ler_varint(dados + pos + n1, tamanho - pos - n1, &repeticoes) : 0;
+        if (n2 == 0 || repeticoes > num_pulos - lidos) {
+            free(dados);
+            free(pulos);
+            return -1;
+        }
+        pos += n1 + n2;
+        
+        uint32_t inicio = fim_anterior + intervalo;
+        for (uint32_t r = 0; r < repeticoes; r++) {
+            pulos[lidos++] = inicio + r;
+        }
+        fim_anterior = inicio + repeticoes;
+    }
+    free(dados);
+    
+    if (lidos != num_pulos) {
+        free(pulos);
+        return -1;
+    }
+    
+    replay->semente = ler_u64(cabecalho + 8);
+    replay->quadros = ler_u32(cabecalho + 16);
+    replay->pontuacao = (int32_t)ler_u32(cabecalho + 20);
+    replay->largura = largura;
+    replay->altura = altura;
+    replay->dificuldade = cabecalho[5];
+    replay->pulos = pulos;
+    replay->num_pulos = num_pulos;
+    replay->capacidade = num_pulos;
+    return 0;
+}
+
+// Indica se há pulo gravado no quadro dado, avançando o cursor de leitura
+int pulo_no_quadro(const Replay *replay, uint32_t *cursor, uint32_t quadro) {
+    while (*cursor < replay->num_pulos && replay->pulos[*cursor] < quadro) {
+        (*cursor)++;
+    }
+    return *cursor < replay->num_pulos && replay->pulos[*cursor] == quadro;
+}
+
+// Reproduz a partida inteira sem terminal, o mais rápido possível, até o
+// game over ou o último quadro gravado
+void reproduzir_replay(const Replay *replay, Jogo *jogo) {
+    uint32_t cursor = 0;
+    
+    inicializar_jogo(jogo, replay->semente, replay->largura, replay->altura, replay->dificuldade);
+    while (!jogo->game_over && (uint32_t)jogo->quadros < replay->quadros) {
+        if (pulo_no_quadro(replay, &cursor, (uint32_t)jogo->quadros)) {
+            pular(jogo);
+        }
+        avancar_jogo(jogo);
+    }
+}
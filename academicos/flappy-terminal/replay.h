@@ -0,0 +1,53 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "jogo.h"
+
+#define REPLAY_MAGICA "FBRP"
+#define REPLAY_VERSAO 4
+#define REPLAY_TAMANHO_CABECALHO 36
+
+// Gravação de uma partida: a semente recria os obstáculos e a lista de
+// quadros com pulo recria as decisões do jogador. Um pulo no quadro q é
+// aplicado quando jogo.quadros == q, antes do passo de física seguinte.
+//
+// Formato do arquivo (inteiros little-endian):
+//   0  "FBRP"            4 bytes
+//   4  versão             1 byte; a versão 3 passou a física para ponto
+//                         fixo e a 4 o gerador de obstáculos, e gravações
+//                         antigas são recusadas
+//   5  dificuldade        1 byte (+2 reservados)
+//   8  semente            8 bytes
+//   16 quadros da partida 4 bytes
+//   20 pontuação final    4 bytes
+//   24 número de pulos    4 bytes
+//   28 tamanho dos dados  4 bytes
+//   32 largura do campo   2 bytes
+//   34 altura do campo    2 bytes
+//   36 dados: pares (intervalo, repetições) em varint LEB128, onde intervalo
+//      é a distância desde o fim da sequência anterior de quadros com pulo
+//      e repetições é quantos quadros seguidos tiveram pulo
+typedef struct {
+    uint64_t semente;
+    uint32_t quadros;
+    int32_t pontuacao;
+    uint16_t largura, altura;
+    uint8_t dificuldade;
+    uint32_t *pulos;
+    uint32_t num_pulos;
+    uint32_t capacidade;
+} Replay;
+
+void iniciar_replay(Replay *replay, const Jogo *jogo);
+void liberar_replay(Replay *replay);
+int registrar_pulo(Replay *replay, uint32_t quadro);
+void descartar_pulos_desde(Replay *replay, uint32_t quadro);
+void finalizar_replay(Replay *replay, const Jogo *jogo);
+int salvar_replay(const Replay *replay, const char *caminho);
+int carregar_replay(Replay *replay, const char *caminho);
+int pulo_no_quadro(const Replay *replay, uint32_t *cursor, uint32_t quadro);
+void reproduzir_replay(const Replay *replay, Jogo *jogo);
+
+#endif
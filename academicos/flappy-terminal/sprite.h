@@ -0,0 +1,69 @@
+#ifndef SPRITE_H
+#define SPRITE_H
+
+#include <stdint.h>
+
+// Sprites do pássaro: uma grade de ALTURA_SPRITE x LARGURA_SPRITE células cuja
+// célula (ORIGEM_SPRITE_Y, ORIGEM_SPRITE_X) fica sobre a posição (x, y) do pássaro
+#define ALTURA_SPRITE 4
+#define LARGURA_SPRITE 6
+#define ORIGEM_SPRITE_X 2
+#define ORIGEM_SPRITE_Y 1
+
+// Na máscara empacotada, a linha i ocupa os bits [i * BITS_LINHA_SPRITE, (i + 1) * BITS_LINHA_SPRITE)
+#define BITS_LINHA_SPRITE 16
+#define MASCARA_LINHA_SPRITE 0xFFFFULL
+
+// Cada linha tem os glifos, a máscara de ocupação (bit j = coluna j) e a
+// caixa envolvente das células ocupadas, relativa à posição do pássaro
+typedef struct {
+    char glifos[ALTURA_SPRITE][LARGURA_SPRITE + 1];
+    uint8_t mascara[ALTURA_SPRITE];
+    uint64_t linhas;
+    int8_t esquerda, direita, topo, base;
+} Sprite;
+
+_Static_assert(ALTURA_SPRITE * BITS_LINHA_SPRITE <= 64, "máscara empacotada não cabe em 64 bits");
+
+// A caixa envolvente é derivada das máscaras em tempo de compilação
+#define BIT_MAIS_BAIXO(m) \
+    ((m) & 1 ? 0 : (m) & 2 ? 1 : (m) & 4 ? 2 : (m) & 8 ? 3 : (m) & 16 ? 4 : 5)
+#define BIT_MAIS_ALTO(m) \
+    ((m) & 32 ? 5 : (m) & 16 ? 4 : (m) & 8 ? 3 : (m) & 4 ? 2 : (m) & 2 ? 1 : 0)
+#define SPRITE(g0, g1, g2, g3, m0, m1, m2, m3) {                        \
+    { g0, g1, g2, g3 },                                                 \
+    { m0, m1, m2, m3 },                                                 \
+    (uint64_t)(m0) | (uint64_t)(m1) << BITS_LINHA_SPRITE |              \
+        (uint64_t)(m2) << 2 * BITS_LINHA_SPRITE |                       \
+        (uint64_t)(m3) << 3 * BITS_LINHA_SPRITE,                        \
+    BIT_MAIS_BAIXO((m0) | (m1) | (m2) | (m3)) - ORIGEM_SPRITE_X,        \
+    BIT_MAIS_ALTO((m0) | (m1) | (m2) | (m3)) - ORIGEM_SPRITE_X,         \
+    ((m0) ? 0 : (m1) ? 1 : (m2) ? 2 : 3) - ORIGEM_SPRITE_Y,             \
+    ((m3) ? 3 : (m2) ? 2 : (m1) ? 1 : 0) - ORIGEM_SPRITE_Y              \
+}
+
+// Um sprite por nível de evolução; níveis acima do último repetem o último
+static const Sprite SPRITES_PASSARO[] = {
+    SPRITE("      ", "      ", "      ", " #    ", 0x00, 0x00, 0x00, 0x02),
+    SPRITE("      ", "      ", "      ", " ##   ", 0x00, 0x00, 0x00, 0x06),
+    SPRITE("      ", "      ", "      ", " ###  ", 0x00, 0x00, 0x00, 0x0E),
+    SPRITE("      ", "      ", "#     ", " ###  ", 0x00, 0x00, 0x01, 0x0E),
+    SPRITE("      ", "      ", "##    ", " ###  ", 0x00, 0x00, 0x03, 0x0E),
+    SPRITE("      ", "      ", "###   ", " ###  ", 0x00, 0x00, 0x07, 0x0E),
+    SPRITE("      ", "      ", "####  ", " ###  ", 0x00, 0x00, 0x0F, 0x0E),
+    SPRITE("      ", " #    ", "####  ", " ###  ", 0x00, 0x02, 0x0F, 0x0E),
+    SPRITE("      ", " ##   ", "####  ", " ###  ", 0x00, 0x06, 0x0F, 0x0E),
+    SPRITE("      ", " ###  ", "####  ", " ###  ", 0x00, 0x0E, 0x0F, 0x0E),
+    SPRITE(" #    ", " ###  ", "####  ", " ###  ", 0x02, 0x0E, 0x0F, 0x0E),
+    SPRITE(" ##   ", " ###  ", "####  ", " ###  ", 0x06, 0x0E, 0x0F, 0x0E),
+    SPRITE(" ##>  ", " ###  ", "####  ", " ###  ", 0x0E, 0x0E, 0x0F, 0x0E),
+};
+
+#define NUM_SPRITES_PASSARO ((int)(sizeof(SPRITES_PASSARO) / sizeof(SPRITES_PASSARO[0])))
+
+// Sprite de um nível de evolução
+static inline const Sprite *sprite_passaro(int nivel) {
+    return &SPRITES_PASSARO[nivel < NUM_SPRITES_PASSARO ? nivel : NUM_SPRITES_PASSARO - 1];
+}
+
+#endif
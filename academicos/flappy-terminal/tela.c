@@ -0,0 +1,707 @@
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include "tela.h"
+#include "sprite.h"
+#include "metricas.h"
+
+#define LACUNA_MAXIMA_DIFF 4
+#define ALINHAMENTO_TELA 64
+
+// Sequências UTF-8 dos glifos especiais (blocos U+2588, U+2580 e U+2584 e
+// linhas e cantos U+2500, U+2502, U+250C, U+2510, U+2514 e U+2518)
+static const char *const GLIFOS_UTF8[0x20] = {
+    [GLIFO_BLOCO] = "\xE2\x96\x88",
+    [GLIFO_METADE_SUPERIOR] = "\xE2\x96\x80",
+    [GLIFO_METADE_INFERIOR] = "\xE2\x96\x84",
+    [GLIFO_HORIZONTAL] = "\xE2\x94\x80",
+    [GLIFO_VERTICAL] = "\xE2\x94\x82",
+    [GLIFO_CANTO_SUPERIOR_ESQUERDO] = "\xE2\x94\x8C",
+    [GLIFO_CANTO_SUPERIOR_DIREITO] = "\xE2\x94\x90",
+    [GLIFO_CANTO_INFERIOR_ESQUERDO] = "\xE2\x94\x94",
+    [GLIFO_CANTO_INFERIOR_DIREITO] = "\xE2\x94\x98",
+};
+
+// Sequências SGR de cada atributo: só a cor do texto muda. As linhas têm
+// tamanho fixo para que a cópia seja sempre de BYTES_MAXIMOS_SGR bytes
+static const char SGR_ATRIBUTOS[NUM_ATRIBUTOS][BYTES_MAXIMOS_SGR + 1] = {
+    [ATRIBUTO_PADRAO] = "\033[m",
+    [ATRIBUTO_CANO] = "\033[32m",
+    [ATRIBUTO_PASSARO] = "\033[33m",
+    [ATRIBUTO_ROBO] = "\033[36m",
+};
+
+static const uint8_t TAMANHO_SGR[NUM_ATRIBUTOS] = {
+    [ATRIBUTO_PADRAO] = 3,
+    [ATRIBUTO_CANO] = 5,
+    [ATRIBUTO_PASSARO] = 5,
+    [ATRIBUTO_ROBO] = 5,
+};
+
+// Bytes já codificados de cada código de célula; a cópia sempre move
+// BYTES_MAXIMOS_CELULA bytes e avança só `tamanho`
+typedef struct {
+    char bytes[BYTES_MAXIMOS_CELULA];
+    uint8_t tamanho;
+} GlifoCodificado;
+
+static GlifoCodificado glifos_codificados[256];
+
+// Preenche a tabela de glifos codificados: os especiais viram UTF-8 e os
+// demais códigos são copiados como estão
+static void codificar_glifos(void) {
+    for (int c = 0; c < 256; c++) {
+        GlifoCodificado *glifo = &glifos_codificados[c];
+        if (c < 0x20 && GLIFOS_UTF8[c] != NULL) {
+            memcpy(glifo->bytes, GLIFOS_UTF8[c], BYTES_MAXIMOS_CELULA);
+            glifo->tamanho = (uint8_t)strlen(GLIFOS_UTF8[c]);
+        } else {
+            glifo->bytes[0] = (char)c;
+            glifo->tamanho = 1;
+        }
+    }
+}
+
+static size_t arredondar_alinhamento(size_t tamanho) {
+    return (tamanho + ALINHAMENTO_TELA - 1) & ~(size_t)(ALINHAMENTO_TELA - 1);
+}
+
+// Centraliza um texto na linha e o recorta contra as bordas do campo
+static void posicionar_trecho(const Tela *tela, TrechoTexto *trecho, int linha, const char *texto) {
+    int tamanho = (int)strlen(texto);
+    int coluna = (tela->largura - tamanho) / 2;
+    
+    trecho->linha = linha;
+    trecho->texto = texto;
+    if (coluna < 1) {
+        trecho->texto += 1 - coluna;
+        tamanho -= 1 - coluna;
+        coluna = 1;
+    }
+    if (coluna + tamanho > tela->largura - 1) {
+        tamanho = tela->largura - 1 - coluna;
+    }
+    trecho->coluna = coluna;
+    trecho->tamanho = tamanho > 0 && linha >= 1 && linha < tela->altura - 1 ? tamanho : 0;
+}
+
+// Acrescenta um texto centralizado na linha a uma camada
+static void adicionar_trecho(const Tela *tela, Camada *camada, int linha, const char *texto) {
+    posicionar_trecho(tela, &camada->trechos[camada->num_trechos++], linha, texto);
+}
+
+// Compõe as camadas fixas da interface para o tamanho atual da tela
+static void compor_camadas(Tela *tela) {
+    Camada *menu = &tela->camada_menu;
+    menu->num_trechos = 0;
+    adicionar_trecho(tela, menu, 4, "=== FLAPPY TERMINAL ===");
+    adicionar_trecho(tela, menu, 6, "Controles:");
+    adicionar_trecho(tela, menu, 7, "ESPACO - Pular / Iniciar jogo");
+    adicionar_trecho(tela, menu, 8, "R - Reiniciar (apos game over)");
+    adicionar_trecho(tela, menu, 9, "Q - Sair (apos game over)");
+    adicionar_trecho(tela, menu, 10, "V - Voltar no tempo / E - Salvar estado");
+    adicionar_trecho(tela, menu, 11, "H - Painel de desempenho");
+    adicionar_trecho(tela, menu, 12, "Pressione ESPACO para iniciar...");
+    
+    Camada *game_over = &tela->camada_game_over;
+    game_over->num_trechos = 0;
+    adicionar_trecho(tela, game_over, tela->altura / 2, "GAME OVER!");
+    adicionar_trecho(tela, game_over, tela->altura / 2 + 2, "Pressione R para reiniciar");
+    adicionar_trecho(tela, game_over, tela->altura / 2 + 4, "Pressione Q para sair");
+    adicionar_trecho(tela, game_over, tela->altura / 2 + 6, "Pressione V para voltar no tempo");
+    
+    // Força a pontuação a ser formatada e centralizada de novo no próximo quadro
+    tela->pontuacao_exibida = -1;
+}
+
+// Aloca a tela em um único bloco alinhado à linha de cache: os quadros em
+// composição, o último quadro enviado, os planos de atributos de cada um e
+// a arena de saída. Cada linha ocupa `passo` bytes (largura arredondada para
+// 64), então linhas começam alinhadas. Depois disso o loop do jogo não faz
+// mais nenhuma alocação. Retorna 0 em sucesso
+int inicializar_tela(Tela *tela, int largura, int altura) {
+    tela->largura = largura;
+    tela->altura = altura;
+    tela->passo = (int)arredondar_alinhamento(largura);
+    
+    size_t tamanho_quadro = (size_t)altura * tela->passo;
+    size_t tamanho_planos = (NUM_QUADROS_TELA + 1) * tamanho_quadro;
+    // Pior caso da saída: cada trecho alterado custa um movimento de cursor,
+    // e trechos são separados por pelo menos LACUNA_MAXIMA_DIFF células iguais;
+    // no modo Unicode uma célula pode virar até BYTES_MAXIMOS_CELULA bytes, e
+    // no modo colorido pode vir precedida de uma troca de cor
+    tela->capacidade_saida = arredondar_alinhamento(
+        (size_t)altura * (largura * (BYTES_MAXIMOS_CELULA + BYTES_MAXIMOS_SGR + 1) + 16) + 64);
+    
+    char *bloco = aligned_alloc(ALINHAMENTO_TELA, 2 * tamanho_planos + tela->capacidade_saida);
+    if (bloco == NULL) {
+        return -1;
+    }
+    
+    for (int i = 0; i < NUM_QUADROS_TELA; i++) {
+        tela->quadros[i] = bloco + i * tamanho_quadro;
+        tela->planos_atributos[i] = (uint8_t *)bloco + tamanho_planos + i * tamanho_quadro;
+    }
+    tela->anterior = bloco + NUM_QUADROS_TELA * tamanho_quadro;
+    tela->atributos_anteriores = (uint8_t *)bloco + tamanho_planos + NUM_QUADROS_TELA * tamanho_quadro;
+    tela->saida = bloco + 2 * tamanho_planos;
+    memset(bloco, ' ', tamanho_planos);
+    memset(bloco + tamanho_planos, ATRIBUTO_PADRAO, tamanho_planos);
+    selecionar_quadro(tela, 0);
+    codificar_glifos();
+    tela->descritor = STDOUT_FILENO;
+    tela->unicode = 0;
+    tela->cores = 0;
+    tela->atributo_terminal = ATRIBUTO_PADRAO;
+    tela->bytes_quadro = 0;
+    tela->redesenhar = 1;
+    compor_camadas(tela);
+    return 0;
+}
+
+// Libera o bloco de memória da tela
+void liberar_tela(Tela *tela) {
+    free(tela->quadros[0]);
+    tela->buffer = tela->anterior = tela->saida = NULL;
+    tela->atributos = tela->atributos_anteriores = NULL;
+    for (int i = 0; i < NUM_QUADROS_TELA; i++) {
+        tela->quadros[i] = NULL;
+        tela->planos_atributos[i] = NULL;
+    }
+}
+
+// Passa a compor os próximos quadros no quadro de índice `indice`
+void selecionar_quadro(Tela *tela, int indice) {
+    tela->buffer = tela->quadros[indice];
+    tela->atributos = tela->planos_atributos[indice];
+}
+
+// Liga o modo colorido: canos verdes, pássaro amarelo e bordas com linhas
+// Unicode, que exigem a tradução de glifos do modo Unicode
+void ativar_cores(Tela *tela) {
+    tela->cores = 1;
+    tela->unicode = 1;
+    tela->redesenhar = 1;
+}
+
+// Limpa o buffer da tela preenchendo com espaços (um memset para o quadro
+// inteiro); no modo colorido, os atributos voltam ao padrão
+void limpar_buffer(Tela *tela) {
+    memset(tela->buffer, ' ', (size_t)tela->altura * tela->passo);
+    if (tela->cores) {
+        memset(tela->atributos, ATRIBUTO_PADRAO, (size_t)tela->altura * tela->passo);
+    }
+}
+
+// Marca as células [x, x + tamanho) da linha y com um atributo de cor
+static void pintar(Tela *tela, int y, int x, int tamanho, Atributo atributo) {
+    if (tela->cores) {
+        memset(TELA_ATRIBUTOS(tela, y) + x, atributo, tamanho);
+    }
+}
+
+// Desenha as bordas do jogo (superior, inferior e laterais); no modo colorido
+// com linhas e cantos Unicode
+void desenhar_borda(Tela *tela) {
+    char horizontal = tela->cores ? GLIFO_HORIZONTAL : '-';
+    char vertical = tela->cores ? GLIFO_VERTICAL : '|';
+    char *topo = TELA_LINHA(tela, 0);
+    char *base = TELA_LINHA(tela, tela->altura-1);
+    
+    memset(topo, horizontal, tela->largura);
+    memset(base, horizontal, tela->largura);
+    
+    for (int y = 0; y < tela->altura; y++) {
+        TELA_LINHA(tela, y)[0] = vertical;
+        TELA_LINHA(tela, y)[tela->largura-1] = vertical;
+    }
+    
+    if (tela->cores) {
+        topo[0] = GLIFO_CANTO_SUPERIOR_ESQUERDO;
+        topo[tela->largura-1] = GLIFO_CANTO_SUPERIOR_DIREITO;
+        base[0] = GLIFO_CANTO_INFERIOR_ESQUERDO;
+        base[tela->largura-1] = GLIFO_CANTO_INFERIOR_DIREITO;
+    }
+}
+
+// Escreve as células ligadas em uma máscara de colunas do sprite
+static void preencher_mascara(Tela *tela, int y, int x0, unsigned mascara, const char *glifos, char glifo,
+                              uint8_t atributo) {
+    if (y < 1 || y >= tela->altura-1) {
+        return;
+    }
+    
+    char *linha = TELA_LINHA(tela, y);
+    uint8_t *atributos = TELA_ATRIBUTOS(tela, y);
+    for (; mascara != 0; mascara &= mascara - 1) {
+        int j = __builtin_ctz(mascara);
+        int x = x0 + j;
+        if (x >= 1 && x < tela->largura-1) {
+            linha[x] = glifos != NULL ? glifos[j] : glifo;
+            if (tela->cores) {
+                atributos[x] = atributo;
+            }
+        }
+    }
+}
+
+// Desenha um sprite na posição y (Q16.16). No modo Unicode cada célula tem
+// duas metades, e o sprite se move de meia em meia linha com os blocos ▀ e ▄
+static void desenhar_sprite(Tela *tela, const Sprite *sprite, int x, int32_t y, uint8_t atributo) {
+    int x0 = x - ORIGEM_SPRITE_X;
+    
+    if (!tela->unicode) {
+        int y0 = linha_fixo(y) - ORIGEM_SPRITE_Y;
+        for (int i = 0; i < ALTURA_SPRITE; i++) {
+            preencher_mascara(tela, y0 + i, x0, sprite->mascara[i], sprite->glifos[i], 0, atributo);
+        }
+        return;
+    }
+    
+    int meia_linha = linha_fixo(y * 2);
+    int y0 = (meia_linha - (meia_linha & 1)) / 2 - ORIGEM_SPRITE_Y;
+    
+    if ((meia_linha & 1) == 0) {
+        for (int i = 0; i < ALTURA_SPRITE; i++) {
+            preencher_mascara(tela, y0 + i, x0, sprite->mascara[i], NULL, GLIFO_BLOCO, atributo);
+        }
+        return;
+    }
+    
+    // Meia linha abaixo: a linha i da tela junta a metade de baixo da linha
+    // i - 1 do sprite com a metade de cima da linha i
+    for (int i = 0; i <= ALTURA_SPRITE; i++) {
+        unsigned superior = i > 0 ? sprite->mascara[i - 1] : 0;
+        unsigned inferior = i < ALTURA_SPRITE ? sprite->mascara[i] : 0;
+        preencher_mascara(tela, y0 + i, x0, superior & inferior, NULL, GLIFO_BLOCO, atributo);
+        preencher_mascara(tela, y0 + i, x0, superior & ~inferior, NULL, GLIFO_METADE_SUPERIOR, atributo);
+        preencher_mascara(tela, y0 + i, x0, inferior & ~superior, NULL, GLIFO_METADE_INFERIOR, atributo);
+    }
+}
+
+// Posição em Q16.16 interpolada entre os dois últimos passos da física
+// (fracao em Q16.16, de 0 a UM_FIXO)
+static int32_t interpolar_y(int32_t y_anterior, int32_t y, int32_t fracao) {
+    return y_anterior + (int32_t)((int64_t)(y - y_anterior) * fracao / UM_FIXO);
+}
+
+// Desenha o pássaro no buffer da tela a partir do sprite do seu nível, na
+// posição interpolada entre os dois últimos passos da física
+void desenhar_passaro(Tela *tela, const Jogo *jogo, int32_t fracao) {
+    desenhar_sprite(tela, sprite_passaro(jogo->passaro.nivel_evolucao), jogo->passaro.x,
+                    interpolar_y(jogo->passaro.y_anterior, jogo->passaro.y, fracao), ATRIBUTO_PASSARO);
+}
+
+// Meias linhas antes da linha 0 na camada dos robôs, para sprites que
+// começam acima do campo
+#define MARGEM_CAMADA (2 * ALTURA_SPRITE)
+
+// Desenha os pássaros vivos do mundo. Os robôs formam uma camada: cada um só
+// faz o OR das linhas do sprite em um array de máscaras por meia linha, e a
+// camada inteira é escrita depois, uma vez por linha da tela, então milhares
+// de robôs custam pouco mais que um. Os jogadores vêm por cima, cada um com o
+// próprio sprite e, se forem vários, o número ao lado
+void desenhar_passaros(Tela *tela, const Mundo *mundo, int32_t fracao) {
+    const Passaros *passaros = &mundo->passaros;
+    const Sprite *sprite = sprite_passaro(mundo->nivel);
+    uint8_t camada[2 * ALTURA_MAXIMA + 2 * MARGEM_CAMADA];
+    int tamanho = 2 * tela->altura + 2 * MARGEM_CAMADA;
+    
+    memset(camada, 0, tamanho);
+    for (int w = 0; w < passaros->palavras; w++) {
+        uint64_t robos = passaros->vivos[w];
+        if (w == 0) {
+            robos &= ~mascara_ativos(mundo->num_jogadores);
+        }
+        for (; robos != 0; robos &= robos - 1) {
+            int i = w * 64 + __builtin_ctzll(robos);
+            int meia_linha = linha_fixo(interpolar_y(passaros->y_anterior[i], passaros->y[i], fracao) * 2);
+            if (!tela->unicode) {
+                meia_linha &= ~1;
+            }
+            int inicio = meia_linha - 2 * ORIGEM_SPRITE_Y + MARGEM_CAMADA;
+            if (inicio < 0 || inicio + 2 * ALTURA_SPRITE > tamanho) {
+                continue;
+            }
+            for (int r = 0; r < ALTURA_SPRITE; r++) {
+                camada[inicio + 2 * r] |= sprite->mascara[r];
+                camada[inicio + 2 * r + 1] |= sprite->mascara[r];
+            }
+        }
+    }
+    
+    int x0 = mundo->x - ORIGEM_SPRITE_X;
+    for (int y = 1; y < tela->altura - 1; y++) {
+        unsigned superior = camada[2 * y + MARGEM_CAMADA];
+        unsigned inferior = camada[2 * y + 1 + MARGEM_CAMADA];
+        if (!tela->unicode) {
+            preencher_mascara(tela, y, x0, superior | inferior, NULL, 'o', ATRIBUTO_ROBO);
+            continue;
+        }
+        preencher_mascara(tela, y, x0, superior & inferior, NULL, GLIFO_BLOCO, ATRIBUTO_ROBO);
+        preencher_mascara(tela, y, x0, superior & ~inferior, NULL, GLIFO_METADE_SUPERIOR, ATRIBUTO_ROBO);
+        preencher_mascara(tela, y, x0, inferior & ~superior, NULL, GLIFO_METADE_INFERIOR, ATRIBUTO_ROBO);
+    }
+    
+    for (int i = 0; i < mundo->num_jogadores; i++) {
+        if (!passaro_vivo(passaros, i)) {
+            continue;
+        }
+        const Sprite *sprite_jogador = sprite_passaro(passaros->nivel[i]);
+        int32_t y = interpolar_y(passaros->y_anterior[i], passaros->y[i], fracao);
+        desenhar_sprite(tela, sprite_jogador, mundo->x, y, ATRIBUTO_PASSARO);
+        if (mundo->num_jogadores > 1) {
+            preencher_mascara(tela, linha_fixo(y) + sprite_jogador->base,
+                              mundo->x + sprite_jogador->direita + 1, 1, NULL, (char)('1' + i), ATRIBUTO_PASSARO);
+        }
+    }
+}
+
+// Preenche com '|' as linhas [inicio, fim) do trecho de colunas [x, x + largura).
+// Sem recorte, o tamanho é constante e o memset vira um único store por linha
+static void preencher_faixa(Tela *tela, int inicio, int fim, int x, int largura) {
+    char *linha = TELA_LINHA(tela, inicio) + x;
+    if (largura == LARGURA_OBSTACULO) {
+        for (int y = inicio; y < fim; y++, linha += tela->passo) {
+            memset(linha, '|', LARGURA_OBSTACULO);
+        }
+    } else {
+        for (int y = inicio; y < fim; y++, linha += tela->passo) {
+            memset(linha, '|', largura);
+        }
+    }
+    
+    if (tela->cores) {
+        uint8_t *atributos = TELA_ATRIBUTOS(tela, inicio) + x;
+        for (int y = inicio; y < fim; y++, atributos += tela->passo) {
+            memset(atributos, ATRIBUTO_CANO, largura);
+        }
+    }
+}
+
+// Desenha os obstáculos no buffer: cada obstáculo é recortado uma vez contra o
+// campo e cada linha do cano vira um único memset, então o custo é por linha
+void desenhar_obstaculos(Tela *tela, const Obstaculos *obstaculos) {
+    int limite_direito = tela->largura - 1;
+    int limite_inferior = tela->altura - 1;
+    
+    for (int k = 0; k < obstaculos->num; k++) {
+        int x = obstaculos->x[k];
+        
+        // Os obstáculos estão ordenados por x: os seguintes também estão fora da tela
+        if (x >= limite_direito) {
+            break;
+        }
+        
+        int inicio = x > 1 ? x : 1;
+        int fim = x + LARGURA_OBSTACULO < limite_direito ? x + LARGURA_OBSTACULO : limite_direito;
+        if (inicio >= fim) {
+            continue;
+        }
+        
+        int fim_superior = obstaculos->altura_superior[k] < limite_inferior ? obstaculos->altura_superior[k] : limite_inferior;
+        int inicio_inferior = tela->altura - obstaculos->altura_inferior[k];
+        if (inicio_inferior < 1) {
+            inicio_inferior = 1;
+        }
+        
+        preencher_faixa(tela, 1, fim_superior, inicio, fim - inicio);
+        preencher_faixa(tela, inicio_inferior, limite_inferior, inicio, fim - inicio);
+    }
+}
+
+// Copia cada trecho da camada para o buffer
+void desenhar_camada(Tela *tela, const Camada *camada) {
+    for (int i = 0; i < camada->num_trechos; i++) {
+        const TrechoTexto *trecho = &camada->trechos[i];
+        memcpy(TELA_LINHA(tela, trecho->linha) + trecho->coluna, trecho->texto, trecho->tamanho);
+        pintar(tela, trecho->linha, trecho->coluna, trecho->tamanho, ATRIBUTO_PADRAO);
+    }
+}
+
+// Desenha a interface do usuário (pontuação, menu, game over). A pontuação só
+// é formatada de novo quando muda; o resto vem das camadas pré-compostas
+void desenhar_interface(Tela *tela, const Jogo *jogo, int jogo_iniciado) {
+#if MODO_INVENCIVEL
+    long long periodo_quadro = percentil_fase(FASE_QUADRO, 50);
+    int fps_atual = periodo_quadro > 0 ? (int)(1000000000LL / periodo_quadro) : 0;
+    snprintf(tela->texto_pontuacao, sizeof(tela->texto_pontuacao),
+             "Score: %d | Nivel: %d | FPS: %d | [INVENCIVEL]",
+             jogo->pontuacao, jogo->passaro.nivel_evolucao, fps_atual);
+    posicionar_trecho(tela, &tela->trecho_pontuacao, 2, tela->texto_pontuacao);
+#else
+    if (jogo->pontuacao != tela->pontuacao_exibida) {
+        snprintf(tela->texto_pontuacao, sizeof(tela->texto_pontuacao), "Score: %d", jogo->pontuacao);
+        posicionar_trecho(tela, &tela->trecho_pontuacao, 2, tela->texto_pontuacao);
+        tela->pontuacao_exibida = jogo->pontuacao;
+    }
+#endif
+    
+    const TrechoTexto *pontuacao = &tela->trecho_pontuacao;
+    memcpy(TELA_LINHA(tela, pontuacao->linha) + pontuacao->coluna, pontuacao->texto, pontuacao->tamanho);
+    pintar(tela, pontuacao->linha, pontuacao->coluna, pontuacao->tamanho, ATRIBUTO_PADRAO);
+    
+    if (!jogo_iniciado) {
+        desenhar_camada(tela, &tela->camada_menu);
+    }
+    if (jogo->game_over) {
+        desenhar_camada(tela, &tela->camada_game_over);
+    }
+}
+
+// Interface do modo com vários pássaros: pontuação dos vivos, quantos
+// restam e a pontuação de cada jogador, formatadas a cada quadro
+void desenhar_interface_mundo(Tela *tela, const Mundo *mundo, int jogo_iniciado) {
+    size_t capacidade = sizeof(tela->texto_pontuacao);
+    int n = snprintf(tela->texto_pontuacao, capacidade, "Score: %d | Vivos: %d/%d",
+                     mundo->pontuacao, mundo->num_vivos, mundo->passaros.num);
+    for (int i = 0; i < mundo->num_jogadores && n >= 0 && (size_t)n < capacidade; i++) {
+        n += snprintf(tela->texto_pontuacao + n, capacidade - n, " | J%d: %d", i + 1,
+                      mundo->passaros.pontuacao[i]);
+    }
+    posicionar_trecho(tela, &tela->trecho_pontuacao, 2, tela->texto_pontuacao);
+    tela->pontuacao_exibida = -1;
+    
+    const TrechoTexto *pontuacao = &tela->trecho_pontuacao;
+    memcpy(TELA_LINHA(tela, pontuacao->linha) + pontuacao->coluna, pontuacao->texto, pontuacao->tamanho);
+    pintar(tela, pontuacao->linha, pontuacao->coluna, pontuacao->tamanho, ATRIBUTO_PADRAO);
+    
+    if (!jogo_iniciado) {
+        desenhar_camada(tela, &tela->camada_menu);
+    }
+    if (mundo->game_over) {
+        desenhar_camada(tela, &tela->camada_game_over);
+    }
+}
+
+// Escreve um texto na linha y a partir da coluna x, cortando na borda direita
+void escrever_texto(Tela *tela, int x, int y, const char *texto) {
+    if (y < 1 || y >= tela->altura-1) {
+        return;
+    }
+    for (int i = 0; texto[i] != '\0' && x + i < tela->largura-1; i++) {
+        if (x + i >= 1) {
+            TELA_LINHA(tela, y)[x + i] = texto[i];
+            pintar(tela, y, x + i, 1, ATRIBUTO_PADRAO);
+        }
+    }
+}
+
+// Desenha o painel de desempenho no canto inferior esquerdo: tempos medidos
+// por fase (p50/p99), bytes enviados e quadros descartados ou coalescidos
+void desenhar_hud(Tela *tela) {
+    char linha[96];
+    int y = tela->altura - 5;
+    
+    snprintf(linha, sizeof(linha), " quadro p50 %.2f ms | p99 %.2f ms ",
+             percentil_fase(FASE_QUADRO, 50) / 1e6, percentil_fase(FASE_QUADRO, 99) / 1e6);
+    escrever_texto(tela, 2, y++, linha);
+    
+    snprintf(linha, sizeof(linha), " p99 ms: fisica %.3f | compor %.3f | escrita %.3f ",
+             percentil_fase(FASE_FISICA, 99) / 1e6, percentil_fase(FASE_COMPOSICAO, 99) / 1e6,
+             percentil_fase(FASE_ESCRITA, 99) / 1e6);
+    escrever_texto(tela, 2, y++, linha);
+    
+    uint64_t quadros = total_quadros_escritos();
+    snprintf(linha, sizeof(linha), " bytes/quadro %llu | media %.1f ",
+             (unsigned long long)bytes_ultimo_quadro(),
+             quadros ? (double)total_bytes_escritos() / quadros : 0.0);
+    escrever_texto(tela, 2, y++, linha);
+    
+    snprintf(linha, sizeof(linha), " quadros %llu | descartados %llu | coalescidos %llu ",
+             (unsigned long long)quadros, (unsigned long long)total_quadros_descartados(),
+             (unsigned long long)total_quadros_coalescidos());
+    escrever_texto(tela, 2, y++, linha);
+}
+
+// Escreve um movimento de cursor ANSI (linha e coluna começando em 1) na saída
+size_t escrever_movimento_cursor(char *destino, int linha, int coluna) {
+    char digitos[12];
+    size_t n = 0;
+    
+    destino[n++] = '\033';
+    destino[n++] = '[';
+    
+    int d = 0;
+    do { digitos[d++] = '0' + linha % 10; linha /= 10; } while (linha > 0);
+    while (d > 0) destino[n++] = digitos[--d];
+    destino[n++] = ';';
+    
+    do { digitos[d++] = '0' + coluna % 10; coluna /= 10; } while (coluna > 0);
+    while (d > 0) destino[n++] = digitos[--d];
+    destino[n++] = 'H';
+    
+    return n;
+}
+
+// Envia todos os bytes com uma única chamada write() (repete só em escrita parcial)
+void escrever_saida(int descritor, const char *dados, size_t tamanho) {
+    while (tamanho > 0) {
+        ssize_t escrito = write(descritor, dados, tamanho);
+        if (escrito < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        dados += escrito;
+        tamanho -= escrito;
+    }
+}
+
+// Volta o terminal à cor padrão se o modo colorido deixou outra ativa.
+// Retorna o número de bytes escritos em destino
+size_t restaurar_atributo(Tela *tela, char *destino) {
+    if (tela->atributo_terminal == ATRIBUTO_PADRAO) {
+        return 0;
+    }
+    memcpy(destino, SGR_ATRIBUTOS[ATRIBUTO_PADRAO], TAMANHO_SGR[ATRIBUTO_PADRAO]);
+    tela->atributo_terminal = ATRIBUTO_PADRAO;
+    return TAMANHO_SGR[ATRIBUTO_PADRAO];
+}
+
+// Copia um trecho de células para a saída, traduzindo os glifos especiais
+// pela tabela de bytes já codificados no modo Unicode. No modo colorido a
+// cor só é trocada quando uma célula visível pede outra que não a ativa no
+// terminal, que continua valendo entre trechos e movimentos de cursor;
+// espaços aceitam qualquer cor. Retorna o número de bytes escritos
+static size_t copiar_celulas(const Tela *tela, uint8_t *atributo_ativo, char *destino,
+                             const char *celulas, const uint8_t *atributos, int quantidade) {
+    if (!tela->unicode) {
+        memcpy(destino, celulas, quantidade);
+        return quantidade;
+    }
+    
+    size_t n = 0;
+    if (!tela->cores) {
+        for (int i = 0; i < quantidade; i++) {
+            const GlifoCodificado *glifo = &glifos_codificados[(unsigned char)celulas[i]];
+            memcpy(destino + n, glifo->bytes, BYTES_MAXIMOS_CELULA);
+            n += glifo->tamanho;
+        }
+        return n;
+    }
+    
+    // A cor ativa fica em uma variável local: destino é char * e poderia
+    // apontar para ela, o que forçaria relê-la a cada célula
+    uint8_t ativo = *atributo_ativo;
+    for (int i = 0; i < quantidade; i++) {
+        unsigned char c = celulas[i];
+        if (c != ' ' && atributos[i] != ativo) {
+            ativo = atributos[i];
+            memcpy(destino + n, SGR_ATRIBUTOS[ativo], BYTES_MAXIMOS_SGR);
+            n += TAMANHO_SGR[ativo];
+        }
+        const GlifoCodificado *glifo = &glifos_codificados[c];
+        memcpy(destino + n, glifo->bytes, BYTES_MAXIMOS_CELULA);
+        n += glifo->tamanho;
+    }
+    *atributo_ativo = ativo;
+    return n;
+}
+
+// Célula x mudou desde o último quadro; sem cores, atributos é NULL
+static inline int celula_mudou(const char *atual, const char *anterior, const uint8_t *atributos,
+                               const uint8_t *atributos_anteriores, int x) {
+    return atual[x] != anterior[x] ||
+           (atributos != NULL && atributos[x] != atributos_anteriores[x]);
+}
+
+// Renderiza no terminal apenas as células de um quadro composto que mudaram
+// desde o último quadro enviado (glifo ou cor); o quadro inteiro é montado na
+// arena de saída e enviado com um único write(). Só lê o quadro, então pode
+// rodar em outra thread enquanto o próximo é composto
+void renderizar_quadro(Tela *tela, const char *quadro, const uint8_t *atributos_quadro) {
+    char *saida = tela->saida;
+    size_t n = 0;
+    
+    if (tela->redesenhar) {
+        // A tela limpa equivale a um quadro anterior só com espaços
+        n = restaurar_atributo(tela, saida);
+        memcpy(saida + n, "\033[2J", 4);
+        n += 4;
+        memset(tela->anterior, ' ', (size_t)tela->altura * tela->passo);
+        memset(tela->atributos_anteriores, ATRIBUTO_PADRAO, (size_t)tela->altura * tela->passo);
+        tela->redesenhar = 0;
+    }
+    
+    for (int y = 0; y < tela->altura; y++) {
+        const char *atual = quadro + (size_t)y * tela->passo;
+        char *anterior = tela->anterior + (size_t)y * tela->passo;
+        const uint8_t *atributos = tela->cores ? atributos_quadro + (size_t)y * tela->passo : NULL;
+        uint8_t *atributos_anteriores = tela->atributos_anteriores + (size_t)y * tela->passo;
+        int x = 0;
+        
+        // Linhas iguais são o caso comum e são descartadas com um único memcmp
+        if (memcmp(atual, anterior, tela->largura) == 0 &&
+            (atributos == NULL || memcmp(atributos, atributos_anteriores, tela->largura) == 0)) {
+            continue;
+        }
+        
+        while (x < tela->largura) {
+            if (!celula_mudou(atual, anterior, atributos, atributos_anteriores, x)) {
+                x++;
+                continue;
+            }
+            
+            // Agrupa células alteradas separadas por poucas células iguais,
+            // pois reescrevê-las custa menos que um novo movimento de cursor
+            int inicio = x;
+            int fim = x + 1;
+            int iguais = 0;
+            for (x = fim; x < tela->largura && iguais <= LACUNA_MAXIMA_DIFF; x++) {
+                if (celula_mudou(atual, anterior, atributos, atributos_anteriores, x)) {
+                    fim = x + 1;
+                    iguais = 0;
+                } else {
+                    iguais++;
+                }
+            }
+            
+            n += escrever_movimento_cursor(saida + n, y + 1, inicio + 1);
+            n += copiar_celulas(tela, &tela->atributo_terminal, saida + n, atual + inicio,
+                                atributos != NULL ? atributos + inicio : NULL, fim - inicio);
+            memcpy(anterior + inicio, atual + inicio, fim - inicio);
+            if (atributos != NULL) {
+                memcpy(atributos_anteriores + inicio, atributos + inicio, fim - inicio);
+            }
+            x = fim;
+        }
+    }
+    
+    if (n > 0) {
+        escrever_saida(tela->descritor, saida, n);
+    }
+    tela->bytes_quadro = n;
+}
+
+// Renderiza o quadro em composição
+void renderizar_tela(Tela *tela) {
+    renderizar_quadro(tela, tela->buffer, tela->atributos);
+}
+
+// Codifica um quadro composto inteiro, do zero, como se fosse enviado a um
+// terminal recém-conectado: limpa a tela e escreve todas as linhas. Termina
+// com a mesma cor que o terminal local tem depois do quadro, então as
+// diferenças dos quadros seguintes valem para os dois. Não altera a tela e
+// cabe em capacidade_saida bytes. Retorna o número de bytes escritos
+size_t codificar_quadro_completo(const Tela *tela, const char *quadro, const uint8_t *atributos,
+                                 char *destino) {
+    uint8_t ativo = ATRIBUTO_PADRAO;
+    size_t n = TAMANHO_SGR[ATRIBUTO_PADRAO];
+    
+    memcpy(destino, SGR_ATRIBUTOS[ATRIBUTO_PADRAO], n);
+    memcpy(destino + n, "\033[2J", 4);
+    n += 4;
+    for (int y = 0; y < tela->altura; y++) {
+        n += escrever_movimento_cursor(destino + n, y + 1, 1);
+        n += copiar_celulas(tela, &ativo, destino + n, quadro + (size_t)y * tela->passo,
+                            tela->cores ? atributos + (size_t)y * tela->passo : NULL, tela->largura);
+    }
+    if (ativo != tela->atributo_terminal) {
+        memcpy(destino + n, SGR_ATRIBUTOS[tela->atributo_terminal], BYTES_MAXIMOS_SGR);
+        n += TAMANHO_SGR[tela->atributo_terminal];
+    }
+    return n;
+}
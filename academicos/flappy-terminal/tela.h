@@ -0,0 +1,103 @@
+#ifndef TELA_H
+#define TELA_H
+
+#include <stddef.h>
+#include "jogo.h"
+#include "mundo.h"
+
+// Códigos de célula abaixo de 0x20 são glifos que o renderizador traduz para
+// UTF-8; só aparecem no buffer quando a tela está em modo Unicode
+#define GLIFO_BLOCO '\x01'
+#define GLIFO_METADE_SUPERIOR '\x02'
+#define GLIFO_METADE_INFERIOR '\x03'
+#define GLIFO_HORIZONTAL '\x04'
+#define GLIFO_VERTICAL '\x05'
+#define GLIFO_CANTO_SUPERIOR_ESQUERDO '\x06'
+#define GLIFO_CANTO_SUPERIOR_DIREITO '\x07'
+#define GLIFO_CANTO_INFERIOR_ESQUERDO '\x08'
+#define GLIFO_CANTO_INFERIOR_DIREITO '\x09'
+#define BYTES_MAXIMOS_CELULA 3
+
+// Atributos de cor por célula, só no modo colorido. Todos mudam apenas a cor
+// do texto, então um espaço tem a mesma aparência com qualquer atributo
+typedef enum {
+    ATRIBUTO_PADRAO,
+    ATRIBUTO_CANO,
+    ATRIBUTO_PASSARO,
+    ATRIBUTO_ROBO,
+    NUM_ATRIBUTOS
+} Atributo;
+
+#define BYTES_MAXIMOS_SGR 5
+
+// Quadros compostos alocados por tela: um sendo desenhado, um sendo escrito
+// no terminal e um pronto entre os dois (ver escritor.c)
+#define NUM_QUADROS_TELA 3
+
+#define MAX_TRECHOS_CAMADA 8
+
+// Texto já posicionado e recortado contra o campo, copiado com um memcpy
+typedef struct {
+    int linha, coluna, tamanho;
+    const char *texto;
+} TrechoTexto;
+
+// Sobreposição fixa (menu, game over) composta uma vez por tamanho de tela
+typedef struct {
+    TrechoTexto trechos[MAX_TRECHOS_CAMADA];
+    int num_trechos;
+} Camada;
+
+// Framebuffer contíguo: a linha y começa em buffer + y * passo. O plano de
+// atributos tem o mesmo passo e só é usado no modo colorido. buffer e
+// atributos apontam para o quadro em composição, um dos NUM_QUADROS_TELA
+typedef struct {
+    int largura, altura;
+    int passo;
+    char *buffer;
+    char *anterior;
+    uint8_t *atributos;
+    uint8_t *atributos_anteriores;
+    char *quadros[NUM_QUADROS_TELA];
+    uint8_t *planos_atributos[NUM_QUADROS_TELA];
+    char *saida;
+    size_t capacidade_saida;
+    int descritor;
+    int unicode;
+    int cores;
+    uint8_t atributo_terminal;
+    size_t bytes_quadro;
+    int redesenhar;
+    Camada camada_menu;
+    Camada camada_game_over;
+    TrechoTexto trecho_pontuacao;
+    char texto_pontuacao[80];
+    int pontuacao_exibida;
+} Tela;
+
+#define TELA_LINHA(tela, y) ((tela)->buffer + (size_t)(y) * (tela)->passo)
+#define TELA_ATRIBUTOS(tela, y) ((tela)->atributos + (size_t)(y) * (tela)->passo)
+
+int inicializar_tela(Tela *tela, int largura, int altura);
+void liberar_tela(Tela *tela);
+void ativar_cores(Tela *tela);
+void selecionar_quadro(Tela *tela, int indice);
+void limpar_buffer(Tela *tela);
+void desenhar_borda(Tela *tela);
+void desenhar_passaro(Tela *tela, const Jogo *jogo, int32_t fracao);
+void desenhar_passaros(Tela *tela, const Mundo *mundo, int32_t fracao);
+void desenhar_obstaculos(Tela *tela, const Obstaculos *obstaculos);
+void desenhar_interface(Tela *tela, const Jogo *jogo, int jogo_iniciado);
+void desenhar_interface_mundo(Tela *tela, const Mundo *mundo, int jogo_iniciado);
+void desenhar_camada(Tela *tela, const Camada *camada);
+void escrever_texto(Tela *tela, int x, int y, const char *texto);
+void desenhar_hud(Tela *tela);
+size_t escrever_movimento_cursor(char *destino, int linha, int coluna);
+size_t restaurar_atributo(Tela *tela, char *destino);
+void escrever_saida(int descritor, const char *dados, size_t tamanho);
+void renderizar_quadro(Tela *tela, const char *quadro, const uint8_t *atributos);
+void renderizar_tela(Tela *tela);
+size_t codificar_quadro_completo(const Tela *tela, const char *quadro, const uint8_t *atributos,
+                                 char *destino);
+
+#endif
@@ -0,0 +1,485 @@
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+#include "transmissao.h"
+#include "entrada.h"
+
+#define EVENTOS_POR_ESPERA 64
+
+// Abre um socket Unix de fluxo no caminho dado: para escutar, remove um socket
+// antigo e faz bind + listen; senão conecta. Retorna o descritor ou -1
+static int abrir_socket(const char *caminho, int escutar) {
+    struct sockaddr_un endereco = { .sun_family = AF_UNIX };
+    if (strlen(caminho) >= sizeof(endereco.sun_path)) {
+        return -1;
+    }
+    strcpy(endereco.sun_path, caminho);
+    
+    int descritor = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (descritor < 0) {
+        return -1;
+    }
+    
+    int erro;
+    if (escutar) {
+        unlink(caminho);
+        erro = bind(descritor, (struct sockaddr *)&endereco, sizeof(endereco)) != 0 ||
+               listen(descritor, SOMAXCONN) != 0;
+    } else {
+        erro = connect(descritor, (struct sockaddr *)&endereco, sizeof(endereco)) != 0;
+    }
+    if (erro) {
+        close(descritor);
+        return -1;
+    }
+    return descritor;
+}
+
+// Conecta a uma partida transmitida; retorna o descritor ou -1
+int conectar_transmissao(const char *caminho) {
+    return abrir_socket(caminho, 0);
+}
+
+// Copia o fluxo de uma transmissão conectada para o terminal até ela acabar
+// ou o espectador apertar Q, e fecha a conexão
+void assistir_transmissao(int descritor) {
+    struct pollfd fds[2] = {
+        { .fd = descritor, .events = POLLIN },
+        { .fd = STDIN_FILENO, .events = POLLIN },
+    };
+    char dados[1 << 16];
+    
+    while (1) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (fds[1].revents) {
+            char tecla = 0;
+            if (read(STDIN_FILENO, &tecla, 1) != 1) {
+                fds[1].fd = -1;
+            } else if (tecla == 'q' || tecla == 'Q') {
+                break;
+            }
+        }
+        if (fds[0].revents) {
+            ssize_t lidos = read(descritor, dados, sizeof(dados));
+            if (lidos <= 0) {
+                if (lidos < 0 && errno == EINTR) continue;
+                break;
+            }
+            escrever_saida(STDOUT_FILENO, dados, (size_t)lidos);
+        }
+    }
+    close(descritor);
+}
+
+#ifdef __linux__
+
+// Saída de um quadro já renderizado: as diferenças enviadas ao terminal local
+// e, quando algum espectador pediu, o quadro completo logo depois delas
+typedef struct {
+    char *dados;
+    size_t capacidade;
+    size_t tamanho_diferencas;
+    size_t tamanho_completo;
+} PacoteQuadro;
+
+// Fila circular de um produtor (thread de escrita) e um consumidor (thread
+// de transmissão), como a fila de teclas. Um pacote só é escrito antes de
+// publicado, então o produtor pode realocá-lo sem travar o consumidor
+typedef struct {
+    PacoteQuadro pacotes[CAPACIDADE_FILA_PACOTES];
+    _Alignas(64) _Atomic uint32_t cabeca;
+    _Alignas(64) _Atomic uint32_t cauda;
+} FilaPacotes;
+
+// Espectador conectado. Em dia, recebe as diferenças de cada quadro; se o
+// socket não aceitar um pacote inteiro, o resto fica em `pendente` e os
+// quadros seguintes são pulados até ele esvaziar e receber um quadro completo
+typedef struct {
+    int descritor;
+    int indice;
+    int precisa_quadro_completo;
+    char *pendente;
+    size_t capacidade_pendente;
+    size_t inicio_pendente, fim_pendente;
+} Espectador;
+
+static FilaPacotes fila;
+static Espectador *espectadores[MAX_ESPECTADORES];
+static int num_conectados = 0;
+static _Atomic int conectados = 0;
+static _Atomic int pedir_quadro_completo = 0;
+static _Atomic int pacote_perdido = 0;
+static _Atomic uint64_t quadros_pulados = 0;
+static _Atomic int parar = 0;
+static int descritor_servidor = -1;
+static int descritor_epoll = -1;
+static int descritor_evento = -1;
+static char caminho_servidor[sizeof(((struct sockaddr_un *)0)->sun_path)];
+static pthread_t thread_transmissao;
+static int transmissao_ativa = 0;
+
+// Marca usada em epoll_event.data para o eventfd; o socket de escuta usa NULL
+static char marca_evento;
+
+static void acordar_transmissao(void) {
+    uint64_t um = 1;
+    while (write(descritor_evento, &um, sizeof(um)) < 0 && errno == EINTR);
+}
+
+// Observa o espectador no epoll: erros e desconexão sempre e, quando há bytes
+// pendentes, o socket voltar a aceitar mais. O que o espectador envia é
+// ignorado, então um espectador que fechou só a escrita continua recebendo
+static void observar_espectador(Espectador *espectador, int operacao) {
+    struct epoll_event evento = {
+        .events = espectador->fim_pendente > espectador->inicio_pendente ? EPOLLOUT : 0,
+        .data.ptr = espectador,
+    };
+    epoll_ctl(descritor_epoll, operacao, espectador->descritor, &evento);
+}
+
+static void fechar_espectador(Espectador *espectador) {
+    close(espectador->descritor);
+    free(espectador->pendente);
+    
+    Espectador *ultimo = espectadores[--num_conectados];
+    espectadores[espectador->indice] = ultimo;
+    ultimo->indice = espectador->indice;
+    free(espectador);
+    atomic_store_explicit(&conectados, num_conectados, memory_order_relaxed);
+}
+
+// Envia sem bloquear; o que o socket não aceitar agora fica pendente para o
+// próximo EPOLLOUT. Retorna -1 se a conexão caiu
+static int enviar_espectador(Espectador *espectador, const char *dados, size_t tamanho) {
+    size_t enviados = 0;
+    while (enviados < tamanho) {
+        ssize_t n = send(espectador->descritor, dados + enviados, tamanho - enviados,
+                         MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return -1;
+        }
+        enviados += (size_t)n;
+    }
+    if (enviados == tamanho) {
+        return 0;
+    }
+    
+    size_t restante = tamanho - enviados;
+    if (espectador->capacidade_pendente < restante) {
+        char *pendente = realloc(espectador->pendente, restante);
+        if (pendente == NULL) {
+            return -1;
+        }
+        espectador->pendente = pendente;
+        espectador->capacidade_pendente = restante;
+    }
+    memcpy(espectador->pendente, dados + enviados, restante);
+    espectador->inicio_pendente = 0;
+    espectador->fim_pendente = restante;
+    observar_espectador(espectador, EPOLL_CTL_MOD);
+    return 0;
+}
+
+// Continua o envio dos bytes pendentes; retorna -1 se a conexão caiu
+static int esvaziar_pendente(Espectador *espectador) {
+    while (espectador->inicio_pendente < espectador->fim_pendente) {
+        ssize_t n = send(espectador->descritor, espectador->pendente + espectador->inicio_pendente,
+                         espectador->fim_pendente - espectador->inicio_pendente,
+                         MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return 0;
+            return -1;
+        }
+        espectador->inicio_pendente += (size_t)n;
+    }
+    espectador->inicio_pendente = espectador->fim_pendente = 0;
+    observar_espectador(espectador, EPOLL_CTL_MOD);
+    return 0;
+}
+
+// Aceita todas as conexões na fila do socket de escuta; cada espectador
+// novo começa esperando um quadro completo
+static void aceitar_espectadores(void) {
+    while (1) {
+        int descritor = accept(descritor_servidor, NULL, NULL);
+        if (descritor < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        
+        Espectador *espectador = num_conectados < MAX_ESPECTADORES ? calloc(1, sizeof(Espectador)) : NULL;
+        if (espectador == NULL) {
+            close(descritor);
+            continue;
+        }
+        fcntl(descritor, F_SETFL, O_NONBLOCK);
+        espectador->descritor = descritor;
+        espectador->indice = num_conectados;
+        espectador->precisa_quadro_completo = 1;
+        espectadores[num_conectados++] = espectador;
+        atomic_store_explicit(&conectados, num_conectados, memory_order_relaxed);
+        observar_espectador(espectador, EPOLL_CTL_ADD);
+    }
+}
+
+// Entrega um pacote a cada espectador: as diferenças a quem está em dia, o
+// quadro completo (se houver) a quem espera um. Quem ainda tem bytes
+// pendentes pula o quadro
+static void distribuir_pacote(const PacoteQuadro *pacote) {
+    for (int i = num_conectados - 1; i >= 0; i--) {
+        Espectador *espectador = espectadores[i];
+        const char *dados = pacote->dados;
+        size_t tamanho = pacote->tamanho_diferencas;
+        
+        if (espectador->fim_pendente > espectador->inicio_pendente) {
+            atomic_fetch_add_explicit(&quadros_pulados, 1, memory_order_relaxed);
+            espectador->precisa_quadro_completo = 1;
+            continue;
+        }
+        if (espectador->precisa_quadro_completo) {
+            if (pacote->tamanho_completo == 0) {
+                continue;
+            }
+            dados = pacote->dados + pacote->tamanho_diferencas;
+            tamanho = pacote->tamanho_completo;
+            espectador->precisa_quadro_completo = 0;
+        }
+        if (tamanho > 0 && enviar_espectador(espectador, dados, tamanho) != 0) {
+            fechar_espectador(espectador);
+        }
+    }
+}
+
+// Pede um quadro completo à thread de escrita se algum espectador pronto
+// para recebê-lo estiver esperando; acorda o loop do jogo, que pode estar
+// dormindo em uma tela parada
+static void pedir_quadros_completos(void) {
+    for (int i = 0; i < num_conectados; i++) {
+        const Espectador *espectador = espectadores[i];
+        if (espectador->precisa_quadro_completo && espectador->fim_pendente == espectador->inicio_pendente) {
+            if (!atomic_exchange_explicit(&pedir_quadro_completo, 1, memory_order_relaxed)) {
+                acordar_loop();
+            }
+            return;
+        }
+    }
+}
+
+// Distribui os pacotes publicados pela thread de escrita. Um pacote perdido
+// com a fila cheia deixa todos os espectadores sem base para as diferenças
+static void consumir_pacotes(void) {
+    uint64_t contador;
+    while (read(descritor_evento, &contador, sizeof(contador)) < 0 && errno == EINTR);
+    
+    if (atomic_exchange_explicit(&pacote_perdido, 0, memory_order_acquire)) {
+        for (int i = 0; i < num_conectados; i++) {
+            espectadores[i]->precisa_quadro_completo = 1;
+        }
+    }
+    
+    uint32_t cauda = atomic_load_explicit(&fila.cauda, memory_order_relaxed);
+    uint32_t cabeca = atomic_load_explicit(&fila.cabeca, memory_order_acquire);
+    for (; cauda != cabeca; cauda++) {
+        distribuir_pacote(&fila.pacotes[cauda & (CAPACIDADE_FILA_PACOTES - 1)]);
+        atomic_store_explicit(&fila.cauda, cauda + 1, memory_order_release);
+    }
+}
+
+// Thread de transmissão: um único epoll espera conexões novas, pacotes da
+// thread de escrita e sockets de espectadores lentos que voltaram a aceitar
+// bytes. Os eventos de espectadores são tratados antes da distribuição, que
+// pode fechar conexões
+static void *executar_transmissao(void *arg) {
+    (void)arg;
+    struct epoll_event eventos[EVENTOS_POR_ESPERA];
+    
+    while (!atomic_load_explicit(&parar, memory_order_acquire)) {
+        int n = epoll_wait(descritor_epoll, eventos, EVENTOS_POR_ESPERA, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        
+        int conexoes = 0;
+        int pacotes = 0;
+        for (int i = 0; i < n; i++) {
+            if (eventos[i].data.ptr == NULL) {
+                conexoes = 1;
+                continue;
+            }
+            if (eventos[i].data.ptr == &marca_evento) {
+                pacotes = 1;
+                continue;
+            }
+            
+            Espectador *espectador = eventos[i].data.ptr;
+            if ((eventos[i].events & (EPOLLERR | EPOLLHUP)) || esvaziar_pendente(espectador) != 0) {
+                fechar_espectador(espectador);
+            }
+        }
+        
+        if (conexoes) {
+            aceitar_espectadores();
+        }
+        if (pacotes) {
+            consumir_pacotes();
+        }
+        pedir_quadros_completos();
+    }
+    return NULL;
+}
+
+static void fechar_descritores(void) {
+    close(descritor_servidor);
+    if (descritor_epoll >= 0) close(descritor_epoll);
+    if (descritor_evento >= 0) close(descritor_evento);
+    unlink(caminho_servidor);
+    descritor_servidor = descritor_epoll = descritor_evento = -1;
+}
+
+// Abre o socket da transmissão e inicia a thread que atende os espectadores;
+// a partir daqui cada quadro escrito no terminal também vai para eles.
+// Retorna 0 em sucesso
+int iniciar_transmissao(const char *caminho) {
+    descritor_servidor = abrir_socket(caminho, 1);
+    if (descritor_servidor < 0) {
+        return -1;
+    }
+    strcpy(caminho_servidor, caminho);
+    fcntl(descritor_servidor, F_SETFL, O_NONBLOCK);
+    descritor_epoll = epoll_create1(0);
+    descritor_evento = eventfd(0, EFD_NONBLOCK);
+    
+    struct epoll_event servidor = { .events = EPOLLIN, .data.ptr = NULL };
+    struct epoll_event evento = { .events = EPOLLIN, .data.ptr = &marca_evento };
+    atomic_store_explicit(&parar, 0, memory_order_relaxed);
+    if (descritor_epoll < 0 || descritor_evento < 0 ||
+        epoll_ctl(descritor_epoll, EPOLL_CTL_ADD, descritor_servidor, &servidor) != 0 ||
+        epoll_ctl(descritor_epoll, EPOLL_CTL_ADD, descritor_evento, &evento) != 0 ||
+        pthread_create(&thread_transmissao, NULL, executar_transmissao, NULL) != 0) {
+        fechar_descritores();
+        return -1;
+    }
+    transmissao_ativa = 1;
+    return 0;
+}
+
+// Encerra a thread de transmissão, desconecta os espectadores e remove o
+// socket. A thread de escrita já deve estar parada
+void parar_transmissao(void) {
+    if (!transmissao_ativa) {
+        return;
+    }
+    
+    atomic_store_explicit(&parar, 1, memory_order_release);
+    acordar_transmissao();
+    pthread_join(thread_transmissao, NULL);
+    while (num_conectados > 0) {
+        fechar_espectador(espectadores[num_conectados - 1]);
+    }
+    for (int i = 0; i < CAPACIDADE_FILA_PACOTES; i++) {
+        free(fila.pacotes[i].dados);
+        fila.pacotes[i].dados = NULL;
+        fila.pacotes[i].capacidade = 0;
+    }
+    fechar_descritores();
+    transmissao_ativa = 0;
+}
+
+// Chamada pela thread de escrita depois de cada quadro renderizado: copia as
+// diferenças (e, se pedido, o quadro completo) para a fila e acorda a
+// transmissão. Sem espectadores não faz nada; nunca bloqueia
+void transmitir_quadro(const Tela *tela, const char *quadro, const uint8_t *atributos) {
+    if (atomic_load_explicit(&conectados, memory_order_relaxed) == 0) {
+        return;
+    }
+    int completo = atomic_load_explicit(&pedir_quadro_completo, memory_order_relaxed);
+    if (tela->bytes_quadro == 0 && !completo) {
+        return;
+    }
+    
+    uint32_t cabeca = atomic_load_explicit(&fila.cabeca, memory_order_relaxed);
+    uint32_t cauda = atomic_load_explicit(&fila.cauda, memory_order_acquire);
+    PacoteQuadro *pacote = &fila.pacotes[cabeca & (CAPACIDADE_FILA_PACOTES - 1)];
+    size_t necessario = 2 * tela->capacidade_saida;
+    
+    if (cabeca - cauda == CAPACIDADE_FILA_PACOTES) {
+        atomic_store_explicit(&pacote_perdido, 1, memory_order_release);
+        acordar_transmissao();
+        return;
+    }
+    if (pacote->capacidade < necessario) {
+        free(pacote->dados);
+        pacote->dados = malloc(necessario);
+        pacote->capacidade = pacote->dados != NULL ? necessario : 0;
+        if (pacote->dados == NULL) {
+            atomic_store_explicit(&pacote_perdido, 1, memory_order_release);
+            acordar_transmissao();
+            return;
+        }
+    }
+    
+    memcpy(pacote->dados, tela->saida, tela->bytes_quadro);
+    pacote->tamanho_diferencas = tela->bytes_quadro;
+    pacote->tamanho_completo = 0;
+    if (completo && atomic_exchange_explicit(&pedir_quadro_completo, 0, memory_order_relaxed)) {
+        pacote->tamanho_completo = codificar_quadro_completo(tela, quadro, atributos,
+                                                             pacote->dados + pacote->tamanho_diferencas);
+    }
+    atomic_store_explicit(&fila.cabeca, cabeca + 1, memory_order_release);
+    acordar_transmissao();
+}
+
+int num_espectadores(void) {
+    return atomic_load_explicit(&conectados, memory_order_relaxed);
+}
+
+uint64_t total_quadros_pulados_espectadores(void) {
+    return atomic_load_explicit(&quadros_pulados, memory_order_relaxed);
+}
+
+#else
+
+// Sem epoll a partida não é transmitida, mas ainda pode ser assistida
+int iniciar_transmissao(const char *caminho) {
+    (void)caminho;
+    return -1;
+}
+
+void parar_transmissao(void) {
+}
+
+void transmitir_quadro(const Tela *tela, const char *quadro, const uint8_t *atributos) {
+    (void)tela;
+    (void)quadro;
+    (void)atributos;
+}
+
+int num_espectadores(void) {
+    return 0;
+}
+
+uint64_t total_quadros_pulados_espectadores(void) {
+    return 0;
+}
+
+#endif
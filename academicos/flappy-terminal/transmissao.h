@@ -0,0 +1,20 @@
+#ifndef TRANSMISSAO_H
+#define TRANSMISSAO_H
+
+#include <stdint.h>
+#include "tela.h"
+
+// Pacotes entre a thread de escrita e a de transmissão; com a fila cheia o
+// pacote é descartado e todos os espectadores recebem um quadro completo
+#define CAPACIDADE_FILA_PACOTES 8
+#define MAX_ESPECTADORES 1024
+
+int iniciar_transmissao(const char *caminho);
+void parar_transmissao(void);
+void transmitir_quadro(const Tela *tela, const char *quadro, const uint8_t *atributos);
+int num_espectadores(void);
+uint64_t total_quadros_pulados_espectadores(void);
+int conectar_transmissao(const char *caminho);
+void assistir_transmissao(int descritor);
+
+#endif
@@ -0,0 +1,266 @@
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "treino.h"
+#include "lote.h"
+
+#define FRACAO_ELITE 16
+#define FRACAO_PAIS 4
+#define TAXA_MUTACAO 0.25
+#define DESVIO_MUTACAO 0.3f
+#define BONUS_CANO 100.0f
+#define PENALIDADE_DESVIO 50.0f
+
+// Contador de quadros de um trabalhador, em sua própria linha de cache
+typedef struct {
+    _Alignas(64) long long quadros;
+} ContadorTrabalhador;
+
+// Aptidão média de uma rede nos episódios da geração
+typedef struct {
+    float aptidao;
+    int indice;
+} Classificacao;
+
+// Estado do treino. Em cada geração, cada tarefa é um par (bloco, episódio)
+// e escreve só nas próprias posições de aptidao e canos
+typedef struct {
+    const ConfigTreino *config;
+    Rede *redes;
+    Rede *filhas;
+    BlocoRedes *blocos;
+    uint64_t semente_geracao;
+    float *aptidao;   // [episodio * populacao + individuo]
+    int *canos;       // [episodio * populacao + individuo]
+    Classificacao *ordem;
+    ContadorTrabalhador *contadores;
+} ContextoTreino;
+
+static long long agora_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Aptidão de uma partida encerrada: quadros sobrevividos, um bônus por cano e,
+// se morreu, uma penalidade pela distância vertical até o centro do vão
+static float aptidao_partida(const Jogo *jogo) {
+    float aptidao = (float)jogo->quadros + BONUS_CANO * jogo->pontuacao;
+    if (jogo->game_over) {
+        float observacao[ENTRADAS_REDE];
+        observar_jogo(jogo, observacao);
+        aptidao -= PENALIDADE_DESVIO * fabsf(observacao[3]);
+    }
+    return aptidao;
+}
+
+// Joga um episódio com as redes de um bloco, uma partida por pista, todas
+// com a mesma semente e em passo sincronizado: a cada quadro as observações
+// das pistas vivas são transpostas e uma única passada decide todos os pulos
+static void tarefa_avaliar(void *contexto, uint32_t item, int trabalhador) {
+    ContextoTreino *treino = contexto;
+    const ConfigTreino *config = treino->config;
+    int bloco = (int)item / config->episodios;
+    int episodio = (int)item % config->episodios;
+    Jogo jogos[LARGURA_BLOCO_REDES];
+    ObservacoesBloco observacoes;
+    float observacao[ENTRADAS_REDE];
+    unsigned vivas = (1u << LARGURA_BLOCO_REDES) - 1;
+    long long quadros = 0;
+    
+    inicializar_jogo(&jogos[0], misturar_semente(treino->semente_geracao, (uint64_t)episodio),
+                     config->largura, config->altura, config->dificuldade);
+    for (int p = 1; p < LARGURA_BLOCO_REDES; p++) {
+        jogos[p] = jogos[0];
+    }
+    memset(&observacoes, 0, sizeof(observacoes));
+    
+    while (vivas != 0) {
+        for (unsigned m = vivas; m != 0; m &= m - 1) {
+            int p = __builtin_ctz(m);
+            observar_jogo(&jogos[p], observacao);
+            for (int e = 0; e < ENTRADAS_REDE; e++) {
+                observacoes.valores[e][p] = observacao[e];
+            }
+        }
+        
+        unsigned pulos = decidir_bloco(&treino->blocos[bloco], &observacoes);
+        
+        for (unsigned m = vivas; m != 0; m &= m - 1) {
+            int p = __builtin_ctz(m);
+            Jogo *jogo = &jogos[p];
+            if (pulos & (1u << p)) {
+                pular(jogo);
+            }
+            avancar_jogo(jogo);
+            quadros++;
+            
+            if (jogo->game_over || jogo->quadros >= config->max_quadros) {
+                int posicao = episodio * config->populacao + bloco * LARGURA_BLOCO_REDES + p;
+                treino->aptidao[posicao] = aptidao_partida(jogo);
+                treino->canos[posicao] = jogo->pontuacao;
+                vivas &= ~(1u << p);
+            }
+        }
+    }
+    
+    treino->contadores[trabalhador].quadros += quadros;
+}
+
+// Normal padrão pelo método de Box-Muller
+static float aleatorio_normal(Aleatorio *aleatorio) {
+    double u1 = 1.0 - aleatorio_real(aleatorio);
+    double u2 = aleatorio_real(aleatorio);
+    return (float)(sqrt(-2.0 * log(u1)) * cos(6.283185307179586 * u2));
+}
+
+// Maior aptidão primeiro; empates pelo índice, para a ordem não depender do qsort
+static int comparar_classificacao(const void *a, const void *b) {
+    const Classificacao *x = a;
+    const Classificacao *y = b;
+    if (x->aptidao != y->aptidao) {
+        return x->aptidao < y->aptidao ? 1 : -1;
+    }
+    return x->indice - y->indice;
+}
+
+// Monta a próxima geração: as melhores redes passam sem mudança e as demais
+// são filhas de pais sorteados entre as melhores, com cruzamento uniforme e
+// mutação gaussiana em parte dos pesos
+static void reproduzir(const Rede *redes, Rede *filhas, const Classificacao *ordem, int populacao,
+                       Aleatorio *aleatorio) {
+    int elite = populacao / FRACAO_ELITE > 0 ? populacao / FRACAO_ELITE : 1;
+    int pais = populacao / FRACAO_PAIS > 1 ? populacao / FRACAO_PAIS : 1;
+    
+    for (int i = 0; i < elite; i++) {
+        filhas[i] = redes[ordem[i].indice];
+    }
+    
+    for (int i = elite; i < populacao; i++) {
+        const float *pai = (const float *)&redes[ordem[aleatorio_intervalo(aleatorio, pais)].indice];
+        const float *mae = (const float *)&redes[ordem[aleatorio_intervalo(aleatorio, pais)].indice];
+        float *filha = (float *)&filhas[i];
+        
+        for (int w = 0; w < NUM_PESOS_REDE; w++) {
+            filha[w] = proximo_aleatorio(aleatorio) & 1 ? pai[w] : mae[w];
+            if (aleatorio_real(aleatorio) < TAXA_MUTACAO) {
+                filha[w] += DESVIO_MUTACAO * aleatorio_normal(aleatorio);
+            }
+        }
+    }
+}
+
+// Laço de gerações sobre os buffers já alocados do contexto
+static int treinar(ContextoTreino *treino, Rede *melhor) {
+    const ConfigTreino *config = treino->config;
+    int populacao = config->populacao;
+    int num_blocos = populacao / LARGURA_BLOCO_REDES;
+    Aleatorio aleatorio;
+    
+    semear_aleatorio(&aleatorio, config->semente);
+    for (int i = 0; i < populacao; i++) {
+        float *pesos = (float *)&treino->redes[i];
+        for (int w = 0; w < NUM_PESOS_REDE; w++) {
+            pesos[w] = (float)(2.0 * aleatorio_real(&aleatorio) - 1.0);
+        }
+    }
+    
+    printf("treino: populacao %d, %d episodios por geracao, limite %ld quadros, %d threads, kernel %s\n",
+           populacao, config->episodios, config->max_quadros, config->threads, kernel_rede());
+    
+    for (int geracao = 0; geracao < config->geracoes; geracao++) {
+        for (int b = 0; b < num_blocos; b++) {
+            empacotar_bloco(&treino->blocos[b], &treino->redes[b * LARGURA_BLOCO_REDES], LARGURA_BLOCO_REDES);
+        }
+        for (int t = 0; t < config->threads; t++) {
+            treino->contadores[t].quadros = 0;
+        }
+        treino->semente_geracao = misturar_semente(config->semente, (uint64_t)geracao);
+        
+        long long inicio = agora_ns();
+        if (executar_paralelo(config->threads, (uint32_t)(num_blocos * config->episodios),
+                              tarefa_avaliar, treino) != 0) {
+            return -1;
+        }
+        double segundos = (agora_ns() - inicio) / 1e9;
+        
+        long long quadros = 0;
+        for (int t = 0; t < config->threads; t++) {
+            quadros += treino->contadores[t].quadros;
+        }
+        
+        long long soma_canos = 0;
+        for (int i = 0; i < populacao; i++) {
+            float soma = 0;
+            for (int e = 0; e < config->episodios; e++) {
+                soma += treino->aptidao[e * populacao + i];
+                soma_canos += treino->canos[e * populacao + i];
+            }
+            treino->ordem[i].aptidao = soma / config->episodios;
+            treino->ordem[i].indice = i;
+        }
+        qsort(treino->ordem, populacao, sizeof(Classificacao), comparar_classificacao);
+        
+        int campea = treino->ordem[0].indice;
+        long long canos_campea = 0;
+        for (int e = 0; e < config->episodios; e++) {
+            canos_campea += treino->canos[e * populacao + campea];
+        }
+        *melhor = treino->redes[campea];
+        if (config->caminho != NULL && salvar_rede(melhor, config->caminho) != 0) {
+            fprintf(stderr, "Erro ao salvar a rede em %s\n", config->caminho);
+            return -1;
+        }
+        
+        printf("geracao %3d | canos: melhor %.1f, media %.1f | aptidao %.0f | %.2f s (%.0f quadros/s)\n",
+               geracao + 1, (double)canos_campea / config->episodios,
+               (double)soma_canos / ((long long)populacao * config->episodios),
+               treino->ordem[0].aptidao, segundos, segundos > 0 ? quadros / segundos : 0.0);
+        fflush(stdout);
+        
+        reproduzir(treino->redes, treino->filhas, treino->ordem, populacao, &aleatorio);
+        Rede *troca = treino->redes;
+        treino->redes = treino->filhas;
+        treino->filhas = troca;
+    }
+    return 0;
+}
+
+// Treina uma população de redes por neuroevolução. Cada geração joga
+// `episodios` partidas por rede, em paralelo no pool de threads, e a melhor
+// rede da última geração fica em `melhor` (e em config->caminho). O
+// resultado só depende da semente, não do número de threads. Retorna 0 em
+// sucesso
+int executar_treino(const ConfigTreino *config, Rede *melhor) {
+    int populacao = config->populacao;
+    size_t resultados = (size_t)populacao * config->episodios;
+    ContextoTreino treino = {
+        .config = config,
+        .redes = malloc(sizeof(Rede) * populacao),
+        .filhas = malloc(sizeof(Rede) * populacao),
+        .blocos = aligned_alloc(_Alignof(BlocoRedes), sizeof(BlocoRedes) * (populacao / LARGURA_BLOCO_REDES)),
+        .aptidao = malloc(sizeof(float) * resultados),
+        .canos = malloc(sizeof(int) * resultados),
+        .ordem = malloc(sizeof(Classificacao) * populacao),
+        .contadores = aligned_alloc(64, sizeof(ContadorTrabalhador) * config->threads),
+    };
+    
+    int erro = -1;
+    if (treino.redes != NULL && treino.filhas != NULL && treino.blocos != NULL &&
+        treino.aptidao != NULL && treino.canos != NULL && treino.ordem != NULL &&
+        treino.contadores != NULL) {
+        erro = treinar(&treino, melhor);
+    }
+    
+    free(treino.redes);
+    free(treino.filhas);
+    free(treino.blocos);
+    free(treino.aptidao);
+    free(treino.canos);
+    free(treino.ordem);
+    free(treino.contadores);
+    return erro;
+}
@@ -0,0 +1,21 @@
+#ifndef TREINO_H
+#define TREINO_H
+
+#include "rede.h"
+
+// Parâmetros do treino por neuroevolução
+typedef struct {
+    int geracoes;
+    int populacao;         // arredondada para cima até um múltiplo de LARGURA_BLOCO_REDES
+    int episodios;         // partidas por rede e geração, com as mesmas sementes para todas
+    long max_quadros;      // encerra partidas que sobrevivem além deste limite
+    int threads;
+    uint64_t semente;
+    int largura, altura;
+    int dificuldade;
+    const char *caminho;   // onde a melhor rede é salva a cada geração (NULL = não salva)
+} ConfigTreino;
+
+int executar_treino(const ConfigTreino *config, Rede *melhor);
+
+#endif